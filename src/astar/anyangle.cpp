@@ -0,0 +1,186 @@
+#include "astar/anyangle.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace Math3D;
+
+/*
+Walks the cells from a to b. Along axis i the line leaves a cell at t = (2k + 1) / (2n_i) for the k-th of
+the n_i cells it moves, so comparing (2k_i + 1) * n_j with (2k_j + 1) * n_i tells which axis crosses next
+without any floating point. Axes that cross at the same t are stepped together. The cost is summed as the
+length times 1 plus the extra cost of each stretch, so it is exactly the length when every cost is 1.
+*/
+double getLineCost(const Grid& grid, const Vec3i a, const Vec3i b) {
+    int index = grid.getIndex(a[0], a[1], a[2]);
+    int target = grid.getIndex(b[0], b[1], b[2]);
+    if (index < 0 || target < 0) {
+        return INF;
+    }
+    Vec3i d = b - a;
+    int n[3], delta[3], k[3] = {0, 0, 0};
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    for (int axis = 0; axis < 3; ++axis) {
+        n[axis] = std::abs(d[axis]);
+        Vec3i step;
+        step[axis] = d[axis] < 0 ? -1 : 1;
+        for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+            if (neighbors[i].dx == step[0] && neighbors[i].dy == step[1] && neighbors[i].dz == step[2]) {
+                delta[axis] = neighbors[i].delta;
+            }
+        }
+    }
+
+    int start = index;
+    double extra = 0.0; // sum of the fraction of the line in each cell times the cost of the cell less 1
+    double left = 0.0; // where the line entered the current cell
+    while (index != target) {
+        int first = -1;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (k[axis] < n[axis] && (first < 0 ||
+                (long long) (2*k[axis] + 1) * n[first] < (long long) (2*k[first] + 1) * n[axis])) {
+                first = axis;
+            }
+        }
+        long long crossing = 2*k[first] + 1;
+        int next = index;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (k[axis] < n[axis] && (long long) (2*k[axis] + 1) * n[first] == crossing * n[axis]) {
+                next += delta[axis];
+                k[axis]++;
+            }
+        }
+        if (!grid.isWalkable(next)) {
+            return INF;
+        }
+        double t = (double) crossing / (2 * n[first]);
+        extra += (t - left) * (grid.getCost(index == start ? next : index) - 1);
+        left = t;
+        index = next;
+    }
+    extra += (1.0 - left) * (grid.getCost(target) - 1);
+    return distance(a, b) * (1.0 + extra);
+}
+
+bool hasLineOfSight(const Grid& grid, const Vec3i a, const Vec3i b) {
+    return getLineCost(grid, a, b) < INF;
+}
+
+/*
+Lazy Theta*: a reached cell takes the parent of the cell it was reached from, guessing that the line between
+them is clear and costs its length times the cost of the cell, unless the grid step from that cell is cheaper.
+The guess is only checked once the cell is taken off the open set. The cell then costs the cheaper of the line
+and the steps from its expanded neighbors, as astar() would have it, and goes back on the open set if that
+costs more than the guess so cells are still expanded in order. The start is its own parent.
+*/
+Path thetaStar(const Grid& grid, const Vec3i start, const Vec3i end, SearchArena& arena) {
+    Path path;
+    int startIndex = grid.getIndex(start[0], start[1], start[2]);
+    int endIndex = grid.getIndex(end[0], end[1], end[2]);
+    if (startIndex < 0 || endIndex < 0 || !grid.isWalkable(startIndex) || !grid.isWalkable(endIndex)) {
+        return path;
+    }
+
+    arena.begin(grid.getCellCount());
+    IndexedHeap<double>& open = arena.getOpen();
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    arena.visit(startIndex, 0.0, startIndex);
+    open.push(startIndex, distance(end, start));
+    while (!open.empty()) {
+        int currentIndex = open.pop();
+        Vec3i cell = grid.getCell(currentIndex);
+        int parent = arena.getParent(currentIndex);
+        if (parent != currentIndex) {
+            double guess = arena.getG(currentIndex);
+            double g = arena.getG(parent) + getLineCost(grid, grid.getCell(parent), cell);
+            if (g > guess) {
+                for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+                    int index = currentIndex + neighbors[i].delta;
+                    double viaNeighbor = arena.getG(index) + neighbors[i].cost * grid.getCost(currentIndex);
+                    if (arena.isClosed(index) && viaNeighbor < g) {
+                        g = viaNeighbor;
+                        parent = index;
+                    }
+                }
+            }
+            if (g != guess) {
+                arena.visit(currentIndex, g, parent);
+            }
+            if (g > guess) {
+                open.push(currentIndex, g + distance(end, cell));
+                continue;
+            }
+        }
+        if (currentIndex == endIndex) {
+            break;
+        }
+        arena.close(currentIndex);
+
+        int origin = arena.getParent(currentIndex);
+        Vec3i originCell = grid.getCell(origin);
+        double originG = arena.getG(origin);
+        double g = arena.getG(currentIndex);
+        for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+            const GridNeighbor& neighbor = neighbors[i];
+            int index = currentIndex + neighbor.delta;
+            if (!grid.isWalkable(index) || arena.isClosed(index)) {
+                continue;
+            }
+            Vec3i next = cell + Vec3i(neighbor.dx, neighbor.dy, neighbor.dz);
+            double lineG = originG + distance(next, originCell) * grid.getCost(index);
+            double stepG = g + neighbor.cost * grid.getCost(index);
+            double newG = std::min(lineG, stepG);
+            if (arena.improves(index, newG)) {
+                arena.relax(index, newG, lineG < stepG ? origin : currentIndex, newG + distance(end, next));
+            }
+        }
+    }
+
+    if (!arena.isVisited(endIndex)) {
+        return path;
+    }
+    path.found = true;
+    path.cost = arena.getG(endIndex);
+    for (int index = endIndex; index != startIndex; index = arena.getParent(index)) {
+        path.waypoints.push_back(grid.getCell(index));
+    }
+    path.waypoints.push_back(start);
+    std::reverse(path.waypoints.begin(), path.waypoints.end());
+    return path;
+}
+
+Path thetaStar(const Grid& grid, const Vec3i start, const Vec3i end) {
+    SearchArena arena;
+    return thetaStar(grid, start, end, arena);
+}
+
+Path smoothPath(const Grid& grid, const Path& path) {
+    const std::vector<Vec3i>& waypoints = path.waypoints;
+    if (!path.found || waypoints.size() < 3) {
+        return path;
+    }
+    // cost of the path up to each waypoint
+    std::vector<double> costs(waypoints.size(), 0.0);
+    for (unsigned int i = 1; i < waypoints.size(); ++i) {
+        costs[i] = costs[i - 1] + getLineCost(grid, waypoints[i - 1], waypoints[i]);
+    }
+
+    // extend each line for as long as it is no more expensive than the waypoints it skips, a little slack
+    // lets straight runs through several waypoints merge despite rounding
+    Path smoothed;
+    smoothed.found = true;
+    smoothed.waypoints.push_back(waypoints[0]);
+    unsigned int anchor = 0;
+    for (unsigned int i = 2; i < waypoints.size(); ++i) {
+        double skipped = costs[i] - costs[anchor];
+        if (getLineCost(grid, waypoints[anchor], waypoints[i]) > skipped + 1e-9 * (1.0 + skipped)) {
+            smoothed.cost += getLineCost(grid, waypoints[anchor], waypoints[i - 1]);
+            smoothed.waypoints.push_back(waypoints[i - 1]);
+            anchor = i - 1;
+        }
+    }
+    smoothed.cost += getLineCost(grid, waypoints[anchor], waypoints.back());
+    smoothed.waypoints.push_back(waypoints.back());
+    return smoothed;
+}
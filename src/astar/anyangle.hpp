@@ -0,0 +1,28 @@
+#ifndef ANYANGLE_HPP
+#define ANYANGLE_HPP
+
+#include "astar/astar.hpp"
+#include "astar/grid.hpp"
+#include "astar/searcharena.hpp"
+
+#include "math/vec.hpp"
+
+// cost of walking the straight line from the center of cell a to the center of cell b, infinite when it
+// passes through a blocked cell. the cells are found with an integer 3D DDA, a line through an edge or corner
+// moves diagonally like a grid step does. each cell is charged its cost for the length of the line inside it,
+// except the start, whose part is charged at the cost of the first cell entered, so a single step costs the
+// same as in astar()
+double getLineCost(const Grid& grid, const Math3D::Vec3i a, const Math3D::Vec3i b);
+bool hasLineOfSight(const Grid& grid, const Math3D::Vec3i a, const Math3D::Vec3i b);
+
+// any-angle search (lazy Theta*). like astar(), but a cell may take the parent of the cell it was reached from
+// as its own parent when there is a line of sight between them, so the waypoints are only the turning points
+// and the path is usually shorter than a grid path, and never costs more than the path of astar(). line of sight
+// is only checked when a cell is expanded
+Path thetaStar(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end, SearchArena& arena);
+Path thetaStar(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end);
+
+// drops waypoints of a path wherever a straight line past them costs no more than the waypoints it skips
+Path smoothPath(const Grid& grid, const Path& path);
+
+#endif
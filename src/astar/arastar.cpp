@@ -0,0 +1,169 @@
+#include "astar/arastar.hpp"
+
+#include <algorithm>
+
+#include "astar/deadline.hpp"
+#include "astar/expand.hpp"
+
+using namespace Math3D;
+
+AnytimeSearch::AnytimeSearch(const Grid& grid, const Vec3i start, const Vec3i end, SearchArena& arena,
+                             double weight, double weightStep) :
+    grid(grid), end(end), arena(&arena), weight(std::max(weight, 1.0)), weightStep(weightStep), bound(INF),
+    finished(false), iteration(1), expansions(0) {
+    int startIndex = grid.getIndex(start[0], start[1], start[2]);
+    endIndex = grid.getIndex(end[0], end[1], end[2]);
+    if (startIndex < 0 || endIndex < 0 || !grid.isWalkable(startIndex) || !grid.isWalkable(endIndex)) {
+        finished = true;
+        return;
+    }
+    closed.assign(grid.getCellCount(), 0);
+    listed.assign(grid.getCellCount(), 0);
+    arena.begin(grid.getCellCount());
+    arena.visit(startIndex, 0.0, -1);
+    arena.getOpen().push(startIndex, this->weight * distance(start, end));
+}
+
+bool AnytimeSearch::improve() {
+    if (!finished) {
+        iterate(nullptr);
+    }
+    return finished;
+}
+
+bool AnytimeSearch::improve(std::chrono::microseconds budget) {
+    Deadline deadline(budget);
+    while (!finished && iterate(&deadline)) {}
+    return finished;
+}
+
+/*
+The ImprovePath loop of ARA*: expands cells in order of g + weight * h until none could lead to a
+cheaper end. Returns false if the deadline passed first, the open set is left as it is so the next
+call picks up where this one stopped.
+*/
+bool AnytimeSearch::iterate(Deadline* deadline) {
+    IndexedHeap<double>& open = arena->getOpen();
+    while (!open.empty()) {
+        double endG = arena->isVisited(endIndex) ? arena->getG(endIndex) : INF;
+        if (endG <= open.topPriority()) {
+            break;
+        }
+        if (deadline != nullptr && deadline->passed()) {
+            return false;
+        }
+        expand(open.pop());
+    }
+    endIteration();
+    return true;
+}
+
+void AnytimeSearch::expand(int currentIndex) {
+    closed[currentIndex] = iteration;
+    expansions++;
+
+    // arena->close is never used, closed cells are kept per iteration in closed instead
+    IndexedHeap<double>& open = arena->getOpen();
+    expandNeighbors(grid, *arena, currentIndex, false, true,
+                    [this](const Vec3i next, int) { return weight * distance(next, end); }, AnyCell(),
+                    [&](int index) {
+                        if (closed[index] == iteration) {
+                            // expanded already this iteration, it is reconsidered in the next one instead of now
+                            open.remove(index);
+                            if (listed[index] != iteration) {
+                                listed[index] = iteration;
+                                inconsistent.push_back(index);
+                            }
+                        }
+                    });
+}
+
+/*
+Publishes the path, works out its bound from the lowest unweighted f of the cells still to be
+searched, then lowers the weight and re-keys those cells for the next iteration. The weight never
+needs to be higher than the bound already proven, so it drops straight to that when lower.
+*/
+void AnytimeSearch::endIteration() {
+    IndexedHeap<double>& open = arena->getOpen();
+    frontier.clear();
+    while (!open.empty()) {
+        frontier.push_back(open.pop());
+    }
+    frontier.insert(frontier.end(), inconsistent.begin(), inconsistent.end());
+    inconsistent.clear();
+
+    if (!arena->isVisited(endIndex)) { // the open set ran out, there is no path
+        finished = true;
+        return;
+    }
+    path = Path();
+    path.found = true;
+    for (int index = endIndex; index >= 0; index = arena->getParent(index)) {
+        path.waypoints.push_back(grid.getCell(index));
+    }
+    std::reverse(path.waypoints.begin(), path.waypoints.end());
+    // cells on the way may have been improved since the end was reached, so the parents can give a path
+    // cheaper than g of the end
+    for (unsigned int i = 1; i < path.waypoints.size(); ++i) {
+        const Vec3i cell = path.waypoints[i];
+        path.cost += distance(cell, path.waypoints[i - 1]) * grid.getCost(grid.getIndex(cell[0], cell[1], cell[2]));
+    }
+
+    double lowest = INF;
+    for (unsigned int i = 0; i < frontier.size(); ++i) {
+        int index = frontier[i];
+        lowest = std::min(lowest, arena->getG(index) + distance(grid.getCell(index), end));
+    }
+    bound = lowest >= path.cost ? 1.0 : std::min(weight, path.cost / lowest);
+    if (weight <= 1.0 || bound <= 1.0) {
+        bound = 1.0;
+        finished = true;
+        return;
+    }
+
+    weight = std::max(1.0, std::min(weight - weightStep, bound));
+    iteration++;
+    for (unsigned int i = 0; i < frontier.size(); ++i) {
+        int index = frontier[i];
+        open.push(index, arena->getG(index) + weight * distance(grid.getCell(index), end));
+    }
+}
+
+bool AnytimeSearch::isFinished() const {
+    return finished;
+}
+
+const Path& AnytimeSearch::getPath() const {
+    return path;
+}
+
+double AnytimeSearch::getBound() const {
+    return bound;
+}
+
+double AnytimeSearch::getWeight() const {
+    return weight;
+}
+
+int AnytimeSearch::getIterations() const {
+    return iteration;
+}
+
+int AnytimeSearch::getExpansions() const {
+    return expansions;
+}
+
+Path araStar(const Grid& grid, const Vec3i start, const Vec3i end, std::chrono::microseconds budget,
+             SearchArena& arena, double* bound, double weight) {
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    AnytimeSearch search(grid, start, end, arena, weight);
+    search.improve();
+    std::chrono::steady_clock::duration left = budget - (std::chrono::steady_clock::now() - begin);
+    if (left > std::chrono::steady_clock::duration::zero()) {
+        search.improve(std::chrono::duration_cast<std::chrono::microseconds>(left));
+    }
+    if (bound != nullptr) {
+        *bound = search.getBound();
+    }
+    return search.getPath();
+}
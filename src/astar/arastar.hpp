@@ -0,0 +1,67 @@
+#ifndef ARASTAR_HPP
+#define ARASTAR_HPP
+
+#include <chrono>
+#include <vector>
+
+#include "astar/astar.hpp"
+#include "astar/deadline.hpp"
+#include "astar/grid.hpp"
+#include "astar/searcharena.hpp"
+
+#include "math/vec.hpp"
+
+// anytime repairing A* (ARA*). the first iteration inflates the heuristic by weight and finds a path quickly
+// that costs at most weight times the shortest, each later iteration lowers the weight and repairs the path
+// from the cells already searched instead of starting over, until it is the shortest. the search keeps its
+// state in the arena between calls, so the arena belongs to it. the grid must not change while it is in use
+class AnytimeSearch {
+ public:
+    // weightStep is how much the weight is lowered after each iteration
+    AnytimeSearch(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end, SearchArena& arena,
+                  double weight = 3.0, double weightStep = 0.5);
+
+    // runs the current iteration to its end, returns true once finished
+    bool improve();
+    // runs iterations until finished or the time is up, an iteration cut short carries on in the next call.
+    // returns true once finished
+    bool improve(std::chrono::microseconds budget);
+
+    // finished once the path is the shortest or there is no path
+    bool isFinished() const;
+    // the best path so far, not found until the first iteration ends
+    const Path& getPath() const;
+    // the path costs at most this many times the shortest, 1 once it is the shortest and infinite while there
+    // is no path
+    double getBound() const;
+    // the heuristic weight of the current iteration
+    double getWeight() const;
+    int getIterations() const;
+    int getExpansions() const;
+ private:
+    const Grid& grid;
+    Math3D::Vec3i end;
+    int endIndex;
+    SearchArena* arena;
+    double weight, weightStep;
+    Path path;
+    double bound;
+    bool finished;
+    unsigned int iteration;
+    int expansions;
+    std::vector<unsigned int> closed; // iteration in which each cell was last expanded
+    std::vector<unsigned int> listed; // iteration in which each cell was last added to inconsistent
+    std::vector<int> inconsistent; // cells improved after being expanded this iteration, reopened in the next
+    std::vector<int> frontier; // scratch for re-keying the open set between iterations
+
+    bool iterate(Deadline* deadline);
+    void expand(int currentIndex);
+    void endIteration();
+};
+
+// a path within weight times the shortest, improved for as long as the budget allows. the first path is
+// always waited for, so the budget may be overrun before one is found. bound gets the bound of the result
+Path araStar(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end,
+             std::chrono::microseconds budget, SearchArena& arena, double* bound = nullptr, double weight = 3.0);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef ASTAR_HPP
+#define ASTAR_HPP
+
+#include <vector>
+
+#include "astar/grid.hpp"
+#include "astar/landmarks.hpp"
+#include "astar/searcharena.hpp"
+
+#include "math/vec.hpp"
+
+struct Path {
+    Path() : cost(0.0), found(false) {}
+    // cells from start to end inclusive, empty when not found. each is a neighbor of the one before, except
+    // in any-angle paths where only the turning points are kept
+    std::vector<Math3D::Vec3i> waypoints;
+    double cost;
+    bool found;
+};
+
+// finds the shortest path between two cells through the 26-connected grid. the grid is only read,
+// all search state lives in the arena so concurrent searches just need an arena each
+Path astar(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end, SearchArena& arena);
+Path astar(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end);
+// the same with the landmark (ALT) heuristic, which expands far fewer cells on maps with walls. falls back
+// to the straight line heuristic when the landmarks aren't ready
+Path astar(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end, const Landmarks& landmarks,
+           SearchArena& arena);
+
+#endif
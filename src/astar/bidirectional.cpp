@@ -0,0 +1,80 @@
+#include "astar/bidirectional.hpp"
+
+#include <algorithm>
+
+#include "astar/expand.hpp"
+
+using namespace Math3D;
+
+namespace {
+    /*
+    Expands the best cell of one side. The backward side follows steps in reverse, so a step from a cell
+    costs the cell's own cost instead of the neighbor's. Every cell reached that the other side has also
+    reached joins the two searches into a path, the cheapest of which is kept in best and meet.
+    */
+    void expand(const Grid& grid, SearchArena& arena, const SearchArena& other, bool reverse, const Vec3i target,
+                double& best, int& meet) {
+        int currentIndex = arena.getOpen().pop();
+        arena.close(currentIndex);
+        expandNeighbors(grid, arena, currentIndex, reverse, false,
+                        [&target](const Vec3i cell, int) { return distance(cell, target); }, AnyCell(),
+                        [&](int index) {
+                            double g = arena.getG(index);
+                            if (other.isVisited(index) && g + other.getG(index) < best) {
+                                best = g + other.getG(index);
+                                meet = index;
+                            }
+                        });
+    }
+}
+
+Path bidirectionalAstar(const Grid& grid, const Vec3i start, const Vec3i end, SearchArena& forward,
+                        SearchArena& backward) {
+    Path path;
+    int startIndex = grid.getIndex(start[0], start[1], start[2]);
+    int endIndex = grid.getIndex(end[0], end[1], end[2]);
+    if (startIndex < 0 || endIndex < 0 || !grid.isWalkable(startIndex) || !grid.isWalkable(endIndex)) {
+        return path;
+    }
+
+    forward.begin(grid.getCellCount());
+    backward.begin(grid.getCellCount());
+    IndexedHeap<double>& forwardOpen = forward.getOpen();
+    IndexedHeap<double>& backwardOpen = backward.getOpen();
+    forward.visit(startIndex, 0.0, -1);
+    forwardOpen.push(startIndex, distance(start, end));
+    backward.visit(endIndex, 0.0, -1);
+    backwardOpen.push(endIndex, distance(start, end));
+    double best = startIndex == endIndex ? 0.0 : INF;
+    int meet = startIndex == endIndex ? startIndex : -1;
+    while (!forwardOpen.empty() && !backwardOpen.empty()) {
+        // with a consistent heuristic, any path not found yet costs at least the lowest f on either side
+        if (std::max(forwardOpen.topPriority(), backwardOpen.topPriority()) >= best) {
+            break;
+        }
+        if (forwardOpen.size() <= backwardOpen.size()) {
+            expand(grid, forward, backward, false, end, best, meet);
+        } else {
+            expand(grid, backward, forward, true, start, best, meet);
+        }
+    }
+
+    if (meet < 0) {
+        return path;
+    }
+    path.found = true;
+    path.cost = best;
+    for (int index = meet; index >= 0; index = forward.getParent(index)) {
+        path.waypoints.push_back(grid.getCell(index));
+    }
+    std::reverse(path.waypoints.begin(), path.waypoints.end());
+    for (int index = backward.getParent(meet); index >= 0; index = backward.getParent(index)) {
+        path.waypoints.push_back(grid.getCell(index));
+    }
+    return path;
+}
+
+Path bidirectionalAstar(const Grid& grid, const Vec3i start, const Vec3i end) {
+    SearchArena forward, backward;
+    return bidirectionalAstar(grid, start, end, forward, backward);
+}
@@ -0,0 +1,18 @@
+#ifndef BIDIRECTIONAL_HPP
+#define BIDIRECTIONAL_HPP
+
+#include "astar/astar.hpp"
+#include "astar/grid.hpp"
+#include "astar/searcharena.hpp"
+
+#include "math/vec.hpp"
+
+// bidirectional A*, one search from start towards end and one backwards from end towards start, always
+// expanding the side with the smaller open set. it returns paths of the same cost as astar(). on open maps
+// it expands more cells than astar(), but it gives up as soon as either end turns out to be boxed in, where
+// astar() searches everything reachable from start first. each side needs its own arena
+Path bidirectionalAstar(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end,
+                        SearchArena& forward, SearchArena& backward);
+Path bidirectionalAstar(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end);
+
+#endif
@@ -0,0 +1,490 @@
+#include "astar/clustergraph.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "astar/expand.hpp"
+
+using namespace Math3D;
+
+namespace {
+    bool inside(const Vec3i cell, const Vec3i min, const Vec3i max) {
+        return cell[0] >= min[0] && cell[0] <= max[0] && cell[1] >= min[1] && cell[1] <= max[1] &&
+               cell[2] >= min[2] && cell[2] <= max[2];
+    }
+
+    bool touching(const Vec3i a, const Vec3i b) {
+        return std::abs(a[0] - b[0]) <= 1 && std::abs(a[1] - b[1]) <= 1 && std::abs(a[2] - b[2]) <= 1;
+    }
+
+    /*
+    Searches the cells of the box [min, max] from source, with A* when a target is given and Dijkstra over
+    the whole box otherwise. A reverse search follows steps backwards, so g ends up as the cost from each cell
+    to source rather than from source to each cell (they differ on grids with costs). The search is further
+    limited to the cells allowed returns true for, and ends early once done returns true for a cell taken
+    off the open set.
+    */
+    template <typename Allowed, typename Done>
+    void searchBox(const Grid& grid, int source, int target, const Vec3i min, const Vec3i max, bool reverse,
+                   const Allowed& allowed, Done& done, SearchArena& arena) {
+        Vec3i goal = target >= 0 ? grid.getCell(target) : Vec3i();
+        arena.begin(grid.getCellCount());
+        IndexedHeap<double>& open = arena.getOpen();
+        arena.visit(source, 0.0, -1);
+        open.push(source, target >= 0 ? distance(goal, grid.getCell(source)) : 0.0);
+        while (!open.empty()) {
+            int current = open.pop();
+            if (current == target || done(current)) {
+                return;
+            }
+            arena.close(current);
+
+            expandNeighbors(grid, arena, current, reverse, false,
+                            [&](const Vec3i next, int) { return target >= 0 ? distance(goal, next) : 0.0; },
+                            [&](const Vec3i next, int) { return inside(next, min, max) && allowed(next); },
+                            IgnoreRelaxed());
+        }
+    }
+
+    struct Anywhere {
+        bool operator()(const Vec3i) const {
+            return true;
+        }
+    };
+
+    struct Never {
+        bool operator()(int) const {
+            return false;
+        }
+    };
+
+    void searchBox(const Grid& grid, int source, int target, const Vec3i min, const Vec3i max, bool reverse,
+                   SearchArena& arena) {
+        Never never;
+        searchBox(grid, source, target, min, max, reverse, Anywhere(), never, arena);
+    }
+
+    /*
+    Appends the cells of the path the arena found to target, leaving out the source it started from.
+    */
+    void appendPath(const Grid& grid, const SearchArena& arena, int target, std::vector<Vec3i>& waypoints) {
+        size_t first = waypoints.size();
+        for (int index = target; arena.getParent(index) >= 0; index = arena.getParent(index)) {
+            waypoints.push_back(grid.getCell(index));
+        }
+        std::reverse(waypoints.begin() + first, waypoints.end());
+    }
+}
+
+ClusterGraph::ClusterGraph(Grid& grid, int clusterSize) : grid(grid), clusterSize(clusterSize) {
+    grid.addListener(this);
+    build();
+}
+
+ClusterGraph::~ClusterGraph() {
+    grid.removeListener(this);
+}
+
+void ClusterGraph::build() {
+    clusters.clear();
+    dirty.clear();
+    countX = countY = countZ = 0;
+    if (grid.getCellCount() == 0) {
+        return;
+    }
+    Vec3i extents = grid.getExtents();
+    countX = (2*extents[0] + clusterSize) / clusterSize;
+    countY = (2*extents[1] + clusterSize) / clusterSize;
+    countZ = (2*extents[2] + clusterSize) / clusterSize;
+    clusters.resize(countX * countY * countZ);
+    for (int x = 0; x < countX; x++) {
+        for (int y = 0; y < countY; y++) {
+            for (int z = 0; z < countZ; z++) {
+                int c = (y*countX + x)*countZ + z;
+                Cluster& cluster = clusters[c];
+                cluster.min = Vec3i(x, y, z) * clusterSize - extents;
+                cluster.max = cluster.min + Vec3i::fill(clusterSize - 1);
+                for (int axis = 0; axis < 3; ++axis) {
+                    cluster.max[axis] = std::min(cluster.max[axis], extents[axis]);
+                }
+                cluster.dirty = false;
+                markDirty(c);
+            }
+        }
+    }
+    update();
+}
+
+int ClusterGraph::getCluster(const Vec3i cell) const {
+    Vec3i extents = grid.getExtents();
+    int x = (cell[0] + extents[0]) / clusterSize;
+    int y = (cell[1] + extents[1]) / clusterSize;
+    int z = (cell[2] + extents[2]) / clusterSize;
+    return (y*countX + x)*countZ + z;
+}
+
+int ClusterGraph::getPortal(const Cluster& cluster, int cell) const {
+    for (unsigned int i = 0; i < cluster.portals.size(); ++i) {
+        if (cluster.portals[i].cell == cell) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ClusterGraph::markDirty(int cluster) {
+    if (!clusters[cluster].dirty) {
+        clusters[cluster].dirty = true;
+        dirty.push_back(cluster);
+    }
+}
+
+void ClusterGraph::onCellChanged(int index) {
+    // the cell can be part of a crossing into any cluster it touches, so those are rebuilt too
+    Vec3i cell = grid.getCell(index);
+    Vec3i extents = grid.getExtents();
+    for (int x = -1; x <= 1; x++) {
+        for (int y = -1; y <= 1; y++) {
+            for (int z = -1; z <= 1; z++) {
+                Vec3i next = cell + Vec3i(x, y, z);
+                if (inside(next, -extents, extents)) {
+                    markDirty(getCluster(next));
+                }
+            }
+        }
+    }
+}
+
+void ClusterGraph::onGridReset() {
+    build();
+}
+
+bool ClusterGraph::needsUpdate() const {
+    return !dirty.empty();
+}
+
+void ClusterGraph::update() {
+    // portals first, the distances are between the new portals
+    for (unsigned int i = 0; i < dirty.size(); ++i) {
+        clusters[dirty[i]].portals.clear();
+    }
+    std::vector<int> cellsA, cellsB;
+    for (unsigned int i = 0; i < dirty.size(); ++i) {
+        int c = dirty[i];
+        int cx = (c / countZ) % countX;
+        int cy = c / (countX * countZ);
+        int cz = c % countZ;
+        for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, countX - 1); x++) {
+            for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, countY - 1); y++) {
+                for (int z = std::max(cz - 1, 0); z <= std::min(cz + 1, countZ - 1); z++) {
+                    int other = (y*countX + x)*countZ + z;
+                    if (other == c || (clusters[other].dirty && other < c)) {
+                        continue; // a pair of dirty clusters is done once, from the lower numbered one
+                    }
+                    findCrossings(c, other, cellsA, cellsB);
+                    addCrossings(c, cellsA, cellsB);
+                    if (clusters[other].dirty) {
+                        addCrossings(other, cellsB, cellsA);
+                    }
+                }
+            }
+        }
+    }
+    for (unsigned int i = 0; i < dirty.size(); ++i) {
+        buildDistances(dirty[i]);
+        clusters[dirty[i]].dirty = false;
+    }
+    dirty.clear();
+}
+
+void ClusterGraph::findCrossings(int a, int b, std::vector<int>& cellsA, std::vector<int>& cellsB) const {
+    cellsA.clear();
+    cellsB.clear();
+    // work from the lower numbered cluster so both sides pick the same crossings
+    bool swapped = a > b;
+    const Cluster& lo = clusters[swapped ? b : a];
+    const Cluster& hi = clusters[swapped ? a : b];
+
+    // every step between a walkable cell of lo and a walkable cell of hi
+    std::vector<int> fromLo, toHi;
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    Vec3i bandMin, bandMax;
+    for (int axis = 0; axis < 3; ++axis) {
+        bandMin[axis] = std::max(lo.min[axis], hi.min[axis] - 1);
+        bandMax[axis] = std::min(lo.max[axis], hi.max[axis] + 1);
+    }
+    for (int x = bandMin[0]; x <= bandMax[0]; x++) {
+        for (int y = bandMin[1]; y <= bandMax[1]; y++) {
+            for (int z = bandMin[2]; z <= bandMax[2]; z++) {
+                int index = grid.getIndex(x, y, z);
+                if (!grid.isWalkable(index)) {
+                    continue;
+                }
+                for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+                    const GridNeighbor& neighbor = neighbors[i];
+                    if (inside(Vec3i(x + neighbor.dx, y + neighbor.dy, z + neighbor.dz), hi.min, hi.max) &&
+                        grid.isWalkable(index + neighbor.delta)) {
+                        fromLo.push_back(index);
+                        toHi.push_back(index + neighbor.delta);
+                    }
+                }
+            }
+        }
+    }
+    if (fromLo.empty()) {
+        return;
+    }
+
+    // group crossings whose cells touch on both sides, each group is one entrance. any crossing in a group
+    // can be reached from any other without leaving either cluster, so one per group is enough.
+    // crossings come out sorted by their lo cell, so each lo cell in the band has a range of them
+    int count = fromLo.size();
+    Vec3i band = bandMax - bandMin + Vec3i::fill(1);
+    std::vector<int> rangeStart(band[0] * band[1] * band[2], 0);
+    std::vector<int> rangeEnd(rangeStart.size(), 0);
+    std::vector<Vec3i> cellsLo(count), cellsHi(count);
+    for (int i = 0; i < count; ++i) {
+        cellsLo[i] = grid.getCell(fromLo[i]);
+        cellsHi[i] = grid.getCell(toHi[i]);
+        Vec3i local = cellsLo[i] - bandMin;
+        int slot = (local[0]*band[1] + local[1])*band[2] + local[2];
+        if (rangeEnd[slot] == 0) {
+            rangeStart[slot] = i;
+        }
+        rangeEnd[slot] = i + 1;
+    }
+
+    std::vector<int> group(count);
+    for (int i = 0; i < count; ++i) {
+        group[i] = i;
+    }
+    struct Find {
+        static int root(std::vector<int>& group, int i) {
+            while (group[i] != i) {
+                group[i] = group[group[i]];
+                i = group[i];
+            }
+            return i;
+        }
+    };
+    for (int i = 0; i < count; ++i) {
+        for (int x = -1; x <= 1; x++) {
+            for (int y = -1; y <= 1; y++) {
+                for (int z = -1; z <= 1; z++) {
+                    Vec3i local = cellsLo[i] + Vec3i(x, y, z) - bandMin;
+                    if (!inside(local, Vec3i(), band - Vec3i::fill(1))) {
+                        continue;
+                    }
+                    int slot = (local[0]*band[1] + local[1])*band[2] + local[2];
+                    for (int j = std::max(rangeStart[slot], i + 1); j < rangeEnd[slot]; ++j) {
+                        if (touching(cellsHi[i], cellsHi[j])) {
+                            group[Find::root(group, j)] = Find::root(group, i);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // the crossing nearest the middle of each group represents it
+    std::vector<Vec3i> sums(count);
+    std::vector<int> sizes(count, 0);
+    for (int i = 0; i < count; ++i) {
+        int root = Find::root(group, i);
+        sums[root] = sums[root] + cellsLo[i];
+        sizes[root]++;
+    }
+    std::vector<int> best(count, -1);
+    std::vector<int> bestDistance(count, 0);
+    for (int i = 0; i < count; ++i) {
+        int root = Find::root(group, i);
+        Vec3i d = cellsLo[i] * sizes[root] - sums[root];
+        int distance = d.dot(d);
+        if (best[root] < 0 || distance < bestDistance[root]) {
+            best[root] = i;
+            bestDistance[root] = distance;
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        if (best[i] >= 0) {
+            cellsA.push_back(swapped ? toHi[best[i]] : fromLo[best[i]]);
+            cellsB.push_back(swapped ? fromLo[best[i]] : toHi[best[i]]);
+        }
+    }
+}
+
+void ClusterGraph::addCrossings(int c, const std::vector<int>& from, const std::vector<int>& to) {
+    Cluster& cluster = clusters[c];
+    for (unsigned int i = 0; i < from.size(); ++i) {
+        int p = getPortal(cluster, from[i]);
+        if (p < 0) {
+            Portal portal;
+            portal.cell = from[i];
+            cluster.portals.push_back(portal);
+            p = cluster.portals.size() - 1;
+        }
+        Crossing crossing;
+        crossing.to = to[i];
+        crossing.cost = distance(grid.getCell(to[i]), grid.getCell(from[i])) * grid.getCost(to[i]);
+        cluster.portals[p].crossings.push_back(crossing);
+    }
+}
+
+void ClusterGraph::buildDistances(int c) {
+    Cluster& cluster = clusters[c];
+    // portals are sorted so a cluster comes out the same whether it was rebuilt alone or with its neighbors
+    std::sort(cluster.portals.begin(), cluster.portals.end(), [](const Portal& a, const Portal& b) {
+        return a.cell < b.cell;
+    });
+    for (unsigned int i = 0; i < cluster.portals.size(); ++i) {
+        std::vector<Crossing>& crossings = cluster.portals[i].crossings;
+        std::sort(crossings.begin(), crossings.end(), [](const Crossing& a, const Crossing& b) {
+            return a.to < b.to;
+        });
+    }
+    int count = cluster.portals.size();
+    cluster.distances.assign(count * count, INF);
+    // the search can stop once every portal is settled, usually well before the whole cluster is
+    Vec3i size = cluster.max - cluster.min + Vec3i::fill(1);
+    std::vector<bool> isPortal(size[0] * size[1] * size[2], false);
+    for (int i = 0; i < count; ++i) {
+        Vec3i cell = grid.getCell(cluster.portals[i].cell) - cluster.min;
+        isPortal[(cell[0]*size[1] + cell[1])*size[2] + cell[2]] = true;
+    }
+    for (int i = 0; i < count; ++i) {
+        int remaining = count;
+        auto settled = [&](int index) {
+            Vec3i cell = grid.getCell(index) - cluster.min;
+            if (isPortal[(cell[0]*size[1] + cell[1])*size[2] + cell[2]]) {
+                remaining--;
+            }
+            return remaining == 0;
+        };
+        searchBox(grid, cluster.portals[i].cell, -1, cluster.min, cluster.max, false, Anywhere(), settled, arena);
+        for (int j = 0; j < count; ++j) {
+            if (arena.isVisited(cluster.portals[j].cell)) {
+                cluster.distances[i*count + j] = arena.getG(cluster.portals[j].cell);
+            }
+        }
+    }
+}
+
+Path ClusterGraph::findPath(const Vec3i start, const Vec3i end) {
+    if (needsUpdate()) {
+        update();
+    }
+    return findPath(start, end, arena);
+}
+
+Path ClusterGraph::findPath(const Vec3i start, const Vec3i end, SearchArena& arena) const {
+    Path path;
+    int startIndex = grid.getIndex(start[0], start[1], start[2]);
+    int endIndex = grid.getIndex(end[0], end[1], end[2]);
+    if (startIndex < 0 || endIndex < 0 || !grid.isWalkable(startIndex) || !grid.isWalkable(endIndex)) {
+        return path;
+    }
+    int startCluster = getCluster(start);
+    int endCluster = getCluster(end);
+    const Cluster& first = clusters[startCluster];
+    const Cluster& last = clusters[endCluster];
+
+    // join start and end to the portals of their clusters
+    searchBox(grid, startIndex, -1, first.min, first.max, false, arena);
+    std::vector<double> fromStart(first.portals.size(), INF);
+    for (unsigned int i = 0; i < first.portals.size(); ++i) {
+        if (arena.isVisited(first.portals[i].cell)) {
+            fromStart[i] = arena.getG(first.portals[i].cell);
+        }
+    }
+    double direct = startCluster == endCluster && arena.isVisited(endIndex) ? arena.getG(endIndex) : INF;
+    searchBox(grid, endIndex, -1, last.min, last.max, true, arena);
+    std::vector<double> toEnd(last.portals.size(), INF);
+    for (unsigned int i = 0; i < last.portals.size(); ++i) {
+        if (arena.isVisited(last.portals[i].cell)) {
+            toEnd[i] = arena.getG(last.portals[i].cell);
+        }
+    }
+
+    // A* over the portals
+    arena.begin(grid.getCellCount());
+    IndexedHeap<double>& open = arena.getOpen();
+    auto relax = [&](int index, double newG, int parent) {
+        if (!arena.isClosed(index) && arena.improves(index, newG)) {
+            arena.relax(index, newG, parent, newG + distance(end, grid.getCell(index)));
+        }
+    };
+    arena.visit(startIndex, 0.0, -1);
+    open.push(startIndex, distance(end, start));
+    while (!open.empty()) {
+        int current = open.pop();
+        if (current == endIndex) {
+            break;
+        }
+        arena.close(current);
+        double g = arena.getG(current);
+
+        if (current == startIndex) {
+            for (unsigned int i = 0; i < first.portals.size(); ++i) {
+                if (fromStart[i] < INF) {
+                    relax(first.portals[i].cell, g + fromStart[i], current);
+                }
+            }
+            if (direct < INF) {
+                relax(endIndex, g + direct, current);
+            }
+        }
+        int c = getCluster(grid.getCell(current));
+        const Cluster& cluster = clusters[c];
+        int p = getPortal(cluster, current);
+        if (p < 0) {
+            continue;
+        }
+        int count = cluster.portals.size();
+        for (int j = 0; j < count; ++j) {
+            double distance = cluster.distances[p*count + j];
+            if (j != p && distance < INF) {
+                relax(cluster.portals[j].cell, g + distance, current);
+            }
+        }
+        const std::vector<Crossing>& crossings = cluster.portals[p].crossings;
+        for (unsigned int i = 0; i < crossings.size(); ++i) {
+            relax(crossings[i].to, g + crossings[i].cost, current);
+        }
+        if (c == endCluster && toEnd[p] < INF) {
+            relax(endIndex, g + toEnd[p], current);
+        }
+    }
+    if (!arena.isVisited(endIndex)) {
+        return path;
+    }
+
+    // refine with a search limited to the clusters the abstract path passes through, which finds the shortcuts
+    // that going from portal to portal misses
+    std::vector<bool> corridor(clusters.size(), false);
+    for (int index = endIndex; index >= 0; index = arena.getParent(index)) {
+        corridor[getCluster(grid.getCell(index))] = true;
+    }
+    auto inCorridor = [&](const Vec3i cell) {
+        return corridor[getCluster(cell)];
+    };
+    Never never;
+    Vec3i extents = grid.getExtents();
+    searchBox(grid, startIndex, endIndex, -extents, extents, false, inCorridor, never, arena);
+    path.found = true;
+    path.cost = arena.getG(endIndex);
+    path.waypoints.push_back(start);
+    appendPath(grid, arena, endIndex, path.waypoints);
+    return path;
+}
+
+int ClusterGraph::getClusterCount() const {
+    return clusters.size();
+}
+
+int ClusterGraph::getPortalCount() const {
+    int count = 0;
+    for (unsigned int i = 0; i < clusters.size(); ++i) {
+        count += clusters[i].portals.size();
+    }
+    return count;
+}
@@ -0,0 +1,72 @@
+#ifndef CLUSTERGRAPH_HPP
+#define CLUSTERGRAPH_HPP
+
+#include <vector>
+
+#include "astar/astar.hpp"
+#include "astar/grid.hpp"
+#include "astar/searcharena.hpp"
+
+#include "math/vec.hpp"
+
+// hierarchical pathfinding (HPA*) over a Grid. the grid is split into cubic clusters, neighboring clusters are
+// joined through portal cells (one pair per connected stretch of their shared border) and the shortest paths
+// between the portals of each cluster are precomputed. queries search this small graph and then refine the result
+// with a search limited to the clusters it passes through, so long paths cost about the size of that corridor
+// instead of the whole grid. paths are close to, but not always as short as, those of astar().
+// the graph listens to the grid and only rebuilds the clusters around changed cells, on the next update
+class ClusterGraph : public GridListener {
+ public:
+    ClusterGraph(Grid& grid, int clusterSize = 8);
+    ~ClusterGraph();
+    ClusterGraph(const ClusterGraph&) = delete;
+    ClusterGraph& operator=(const ClusterGraph&) = delete;
+
+    void onCellChanged(int index) override;
+    void onGridReset() override;
+
+    // rebuilds the clusters changed since the last update
+    void update();
+    bool needsUpdate() const;
+    // updates first if needed
+    Path findPath(const Math3D::Vec3i start, const Math3D::Vec3i end);
+    // the graph must be up to date, then this only reads it and can run on several threads with an arena each
+    Path findPath(const Math3D::Vec3i start, const Math3D::Vec3i end, SearchArena& arena) const;
+
+    int getClusterCount() const;
+    int getPortalCount() const;
+ private:
+    struct Crossing {
+        int to; // portal cell in the neighboring cluster
+        double cost;
+    };
+
+    struct Portal {
+        int cell;
+        std::vector<Crossing> crossings;
+    };
+
+    struct Cluster {
+        Math3D::Vec3i min, max; // corners of the box of cells, inclusive
+        std::vector<Portal> portals;
+        std::vector<double> distances; // from portal i to portal j at i * portals.size() + j, INF when unreachable
+        bool dirty;
+    };
+
+    Grid& grid;
+    int clusterSize;
+    int countX, countY, countZ;
+    std::vector<Cluster> clusters;
+    std::vector<int> dirty; // clusters to rebuild on the next update
+    SearchArena arena; // used by update
+
+    void build();
+    int getCluster(const Math3D::Vec3i cell) const;
+    int getPortal(const Cluster& cluster, int cell) const;
+    void markDirty(int cluster);
+    void addCrossings(int cluster, const std::vector<int>& from, const std::vector<int>& to);
+    void buildDistances(int cluster);
+    void findCrossings(int a, int b, std::vector<int>& cellsA, std::vector<int>& cellsB) const;
+};
+
+#endif
@@ -0,0 +1,237 @@
+#include "astar/components.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+
+using namespace Math3D;
+
+namespace {
+    // union-find over cell indices with path halving, roots point to themselves
+    int findRoot(std::vector<int>& parents, int index) {
+        while (parents[index] != index) {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+        return index;
+    }
+
+    void unite(std::vector<int>& parents, int a, int b) {
+        a = findRoot(parents, a);
+        b = findRoot(parents, b);
+        if (a != b) {
+            parents[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    /*
+    Joins every walkable cell in layers [firstY, lastY] to the walkable neighbors before it in index order
+    that are also in those layers. Only cells of those layers are touched, so threads can each take a slab.
+    */
+    void uniteSlab(const Grid& grid, int firstY, int lastY, std::vector<int>& parents) {
+        const GridNeighbor* neighbors = grid.getNeighbors();
+        Vec3i extents = grid.getExtents();
+        for (int y = firstY; y <= lastY; y++) {
+            for (int x = -extents[0]; x <= extents[0]; x++) {
+                for (int z = -extents[2]; z <= extents[2]; z++) {
+                    int index = grid.getIndex(x, y, z);
+                    if (!grid.isWalkable(index)) {
+                        continue;
+                    }
+                    parents[index] = index;
+                    for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+                        const GridNeighbor& neighbor = neighbors[i];
+                        int next = index + neighbor.delta;
+                        if (neighbor.delta < 0 && y + neighbor.dy >= firstY && grid.isWalkable(next)) {
+                            unite(parents, index, next);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+Components::Components(Grid& grid, unsigned int threads) : grid(grid), threads(threads) {
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+        adjacent[i] = 0;
+        for (int j = 0; j < Grid::NEIGHBOR_COUNT; ++j) {
+            if (j != i && std::abs(neighbors[i].dx - neighbors[j].dx) <= 1 &&
+                std::abs(neighbors[i].dy - neighbors[j].dy) <= 1 && std::abs(neighbors[i].dz - neighbors[j].dz) <= 1) {
+                adjacent[i] |= std::uint32_t(1) << j;
+            }
+        }
+    }
+    grid.addListener(this);
+    build();
+}
+
+Components::~Components() {
+    grid.removeListener(this);
+}
+
+void Components::onCellChanged(int index) {
+    bool walkable = grid.isWalkable(index);
+    if (stale || walkable == (labels[index] >= 0)) {
+        return; // relabeled on the next update anyway, or only the cost changed
+    }
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    if (walkable) {
+        // the cell joins every component around it into one
+        int component = -1;
+        for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+            int next = labels[index + neighbors[i].delta];
+            if (next < 0) {
+                continue;
+            }
+            next = find(next);
+            if (component < 0) {
+                component = next;
+            } else if (next != component) {
+                merged[next] = component;
+                componentCount--;
+            }
+        }
+        if (component < 0) {
+            component = merged.size();
+            merged.push_back(component);
+            componentCount++;
+        }
+        labels[index] = component;
+    } else {
+        // if the walkable neighbors still touch each other around the cell, every path through the cell has a
+        // way around it, otherwise the component may have split
+        labels[index] = -1;
+        int groups = countGroups(grid.getWalkableNeighbors(index));
+        if (groups == 0) {
+            componentCount--;
+        } else if (groups > 1) {
+            stale = true;
+        }
+    }
+}
+
+void Components::onGridReset() {
+    stale = true;
+}
+
+bool Components::needsUpdate() const {
+    return stale;
+}
+
+void Components::update() {
+    if (stale) {
+        build();
+    }
+}
+
+void Components::build() {
+    stale = false;
+    merged.clear();
+    componentCount = 0;
+    int cellCount = grid.getCellCount();
+    labels.assign(cellCount, -1);
+    if (cellCount == 0) {
+        return;
+    }
+
+    // each thread unites a slab of y layers, then the slabs are joined across the layers between them
+    Vec3i extents = grid.getExtents();
+    int layers = 2*extents[1] + 1;
+    unsigned int count = threads == 0 ? std::thread::hardware_concurrency() : threads;
+    count = std::max(1u, std::min(count, (unsigned int) layers));
+    std::vector<int> parents(cellCount, -1);
+    std::vector<std::thread> helpers;
+    for (unsigned int i = 1; i < count; ++i) {
+        int firstY = -extents[1] + layers * i / count;
+        int lastY = -extents[1] + layers * (i + 1) / count - 1;
+        helpers.push_back(std::thread(uniteSlab, std::cref(grid), firstY, lastY, std::ref(parents)));
+    }
+    uniteSlab(grid, -extents[1], -extents[1] + layers / count - 1, parents);
+    for (unsigned int i = 0; i < helpers.size(); ++i) {
+        helpers[i].join();
+    }
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    for (unsigned int i = 1; i < count; ++i) {
+        int y = -extents[1] + layers * i / count;
+        for (int x = -extents[0]; x <= extents[0]; x++) {
+            for (int z = -extents[2]; z <= extents[2]; z++) {
+                int index = grid.getIndex(x, y, z);
+                if (!grid.isWalkable(index)) {
+                    continue;
+                }
+                for (int j = 0; j < Grid::NEIGHBOR_COUNT; ++j) {
+                    if (neighbors[j].dy == -1 && grid.isWalkable(index + neighbors[j].delta)) {
+                        unite(parents, index, index + neighbors[j].delta);
+                    }
+                }
+            }
+        }
+    }
+
+    // roots have the lowest index of their component, so they are reached before the rest of it
+    for (int index = 0; index < cellCount; ++index) {
+        if (parents[index] < 0) {
+            continue;
+        }
+        int root = findRoot(parents, index);
+        if (root == index) {
+            labels[index] = componentCount++;
+        } else {
+            labels[index] = labels[root];
+        }
+    }
+    merged.resize(componentCount);
+    for (int i = 0; i < componentCount; ++i) {
+        merged[i] = i;
+    }
+}
+
+int Components::find(int component) const {
+    while (merged[component] != component) {
+        component = merged[component];
+    }
+    return component;
+}
+
+/*
+Counts the groups the walkable neighbors of a cell form when the cell itself is left out, using the bits
+of Grid::getWalkableNeighbors.
+*/
+int Components::countGroups(std::uint32_t walkableNeighbors) const {
+    int groups = 0;
+    while (walkableNeighbors != 0) {
+        std::uint32_t group = walkableNeighbors & -walkableNeighbors;
+        std::uint32_t grown = group;
+        do {
+            group = grown;
+            for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+                if (group & (std::uint32_t(1) << i)) {
+                    grown |= adjacent[i] & walkableNeighbors;
+                }
+            }
+        } while (grown != group);
+        walkableNeighbors &= ~group;
+        groups++;
+    }
+    return groups;
+}
+
+int Components::getComponent(const Vec3i cell) const {
+    int index = grid.getIndex(cell[0], cell[1], cell[2]);
+    if (index < 0 || labels[index] < 0) {
+        return -1;
+    }
+    return find(labels[index]);
+}
+
+bool Components::isConnected(const Vec3i a, const Vec3i b) const {
+    int component = getComponent(a);
+    return component >= 0 && component == getComponent(b);
+}
+
+int Components::getComponentCount() const {
+    return componentCount;
+}
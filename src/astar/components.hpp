@@ -0,0 +1,50 @@
+#ifndef COMPONENTS_HPP
+#define COMPONENTS_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "astar/grid.hpp"
+
+#include "math/vec.hpp"
+
+// labels the connected components of the walkable cells of a grid, so a query between cells in different
+// components can be turned down without searching (a failed search otherwise visits every cell it can reach).
+// the labels listen to the grid: a cell becoming walkable joins the components around it on the spot, and a
+// blocked cell only forces a full relabel, on the next update, when its neighbors aren't connected around it
+class Components : public GridListener {
+ public:
+    // threads is the number of threads a full labeling uses including the caller, 0 uses every core
+    Components(Grid& grid, unsigned int threads = 0);
+    ~Components();
+    Components(const Components&) = delete;
+    Components& operator=(const Components&) = delete;
+
+    void onCellChanged(int index) override;
+    void onGridReset() override;
+
+    // relabels the whole grid if a change may have split a component
+    void update();
+    bool needsUpdate() const;
+
+    // the labels must be up to date for these, then they only read and can be called from any thread
+    // component of the cell, -1 for blocked cells and cells outside the grid
+    int getComponent(const Math3D::Vec3i cell) const;
+    // true if a path between the cells exists
+    bool isConnected(const Math3D::Vec3i a, const Math3D::Vec3i b) const;
+    int getComponentCount() const;
+ private:
+    Grid& grid;
+    unsigned int threads;
+    std::vector<int> labels; // component of each cell, -1 when blocked
+    std::vector<int> merged; // components joined since the last labeling point to the one they joined
+    int componentCount;
+    bool stale;
+    std::uint32_t adjacent[Grid::NEIGHBOR_COUNT]; // neighbors of each neighbor of a cell, as neighbor bits
+
+    void build();
+    int find(int component) const;
+    int countGroups(std::uint32_t walkableNeighbors) const;
+};
+
+#endif
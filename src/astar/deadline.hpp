@@ -0,0 +1,29 @@
+#ifndef DEADLINE_HPP
+#define DEADLINE_HPP
+
+#include <chrono>
+
+// the end of the time budget of a search, checked before each expansion. reading the clock costs about as
+// much as an expansion, so it is only read every CHECK_INTERVAL checks and the budget can be overrun by that
+// many expansions
+class Deadline {
+ public:
+    static const int CHECK_INTERVAL = 64;
+
+    explicit Deadline(std::chrono::microseconds budget) :
+        time(std::chrono::steady_clock::now() + budget), checks(0), expired(false) {}
+
+    // true once the time is up
+    bool passed() {
+        if (!expired && ++checks % CHECK_INTERVAL == 0) {
+            expired = std::chrono::steady_clock::now() >= time;
+        }
+        return expired;
+    }
+ private:
+    std::chrono::steady_clock::time_point time;
+    int checks;
+    bool expired;
+};
+
+#endif
@@ -0,0 +1,217 @@
+#include "astar/dstarlite.hpp"
+
+#include <algorithm>
+
+using namespace Math3D;
+
+DStarLite::DStarLite(Grid& grid, const Vec3i start, const Vec3i goal) :
+    grid(grid), start(start), goal(goal), reset(true) {
+    grid.addListener(this);
+}
+
+DStarLite::~DStarLite() {
+    grid.removeListener(this);
+}
+
+void DStarLite::onCellChanged(int index) {
+    if (!reset) {
+        changed.push_back(index);
+    }
+}
+
+void DStarLite::onGridReset() {
+    reset = true;
+}
+
+void DStarLite::setStart(const Vec3i start) {
+    this->start = start;
+    startIndex = grid.getIndex(start[0], start[1], start[2]);
+}
+
+void DStarLite::setGoal(const Vec3i goal) {
+    this->goal = goal;
+    reset = true;
+}
+
+Vec3i DStarLite::getStart() const {
+    return start;
+}
+
+Vec3i DStarLite::getGoal() const {
+    return goal;
+}
+
+void DStarLite::initialize() {
+    int cellCount = grid.getCellCount();
+    g.assign(cellCount, INF);
+    rhs.assign(cellCount, INF);
+    open.reset(cellCount);
+    changed.clear();
+    reset = false;
+    startIndex = grid.getIndex(start[0], start[1], start[2]);
+    goalIndex = grid.getIndex(goal[0], goal[1], goal[2]);
+    last = start;
+    keyOffset = 0.0;
+    if (goalIndex >= 0) {
+        rhs[goalIndex] = 0.0;
+        open.push(goalIndex, calculateKey(goalIndex));
+    }
+}
+
+double DStarLite::heuristic(int index) const {
+    return distance(grid.getCell(index), start);
+}
+
+DStarLite::Key DStarLite::calculateKey(int index) const {
+    Key key;
+    key.secondary = std::min(g[index], rhs[index]);
+    key.primary = key.secondary + heuristic(index) + keyOffset;
+    return key;
+}
+
+double DStarLite::computeRhs(int index) const {
+    if (!grid.isWalkable(index)) {
+        return INF;
+    }
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    double best = INF;
+    for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+        int next = index + neighbors[i].delta;
+        if (g[next] < INF && grid.isWalkable(next)) {
+            best = std::min(best, neighbors[i].cost * grid.getCost(next) + g[next]);
+        }
+    }
+    return best;
+}
+
+void DStarLite::updateVertex(int index) {
+    if (g[index] != rhs[index]) {
+        if (open.contains(index)) {
+            open.update(index, calculateKey(index));
+        } else {
+            open.push(index, calculateKey(index));
+        }
+    } else if (open.contains(index)) {
+        open.remove(index);
+    }
+}
+
+/*
+Expands inconsistent cells (g != rhs) in key order until the start is consistent and no queued key is
+below its own. Each step out of a cell enters one of its neighbors, so the cells whose rhs depends on a
+cell are its walkable neighbors, and a step into the cell costs its length times the cell's cost.
+*/
+void DStarLite::computeShortestPath() {
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    while (!open.empty() && (open.topPriority() < calculateKey(startIndex) || rhs[startIndex] != g[startIndex])) {
+        int current = open.top();
+        Key oldKey = open.topPriority();
+        Key newKey = calculateKey(current);
+        if (oldKey < newKey) {
+            // queued before the start moved, its key was too low
+            open.update(current, newKey);
+        } else if (g[current] > rhs[current]) {
+            // overconsistent, its cost to the goal dropped
+            g[current] = rhs[current];
+            open.remove(current);
+            double stepCost = grid.isWalkable(current) ? grid.getCost(current) : INF;
+            for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+                int previous = current + neighbors[i].delta;
+                if (previous == goalIndex || !grid.isWalkable(previous)) {
+                    continue;
+                }
+                double newRhs = neighbors[i].cost * stepCost + g[current];
+                if (newRhs < rhs[previous]) {
+                    rhs[previous] = newRhs;
+                    updateVertex(previous);
+                }
+            }
+        } else {
+            // underconsistent, its cost to the goal went up, so every cell that went through it is recomputed
+            double oldG = g[current];
+            g[current] = INF;
+            if (current != goalIndex) {
+                rhs[current] = computeRhs(current);
+            }
+            updateVertex(current);
+            double stepCost = grid.isWalkable(current) ? grid.getCost(current) : INF;
+            for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+                int previous = current + neighbors[i].delta;
+                if (previous == goalIndex || !grid.isWalkable(previous)) {
+                    continue;
+                }
+                if (rhs[previous] < INF && rhs[previous] == neighbors[i].cost * stepCost + oldG) {
+                    rhs[previous] = computeRhs(previous);
+                    updateVertex(previous);
+                }
+            }
+        }
+    }
+}
+
+Path DStarLite::findPath() {
+    Path path;
+    if (reset) {
+        initialize();
+    }
+    if (!changed.empty()) {
+        // the queued keys are lower bounds for the start they were computed with, moving the start lowers
+        // every heuristic by at most the distance moved, so that is added to all keys from now on
+        keyOffset += distance(start, last);
+        last = start;
+        const GridNeighbor* neighbors = grid.getNeighbors();
+        for (unsigned int i = 0; i < changed.size(); ++i) {
+            // a change to a cell changes the steps into it and out of it, so its rhs and those of its neighbors
+            int index = changed[i];
+            if (index != goalIndex) {
+                rhs[index] = computeRhs(index);
+                updateVertex(index);
+            }
+            for (int j = 0; j < Grid::NEIGHBOR_COUNT; ++j) {
+                int previous = index + neighbors[j].delta;
+                if (previous != goalIndex && grid.isWalkable(previous)) {
+                    rhs[previous] = computeRhs(previous);
+                    updateVertex(previous);
+                }
+            }
+        }
+        changed.clear();
+    }
+    if (startIndex < 0 || goalIndex < 0 || !grid.isWalkable(startIndex) || !grid.isWalkable(goalIndex)) {
+        return path;
+    }
+    computeShortestPath();
+    if (g[startIndex] == INF) {
+        return path;
+    }
+
+    // walk down the cost to the goal, the step count guards against a cycle of equal costs
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    int current = startIndex;
+    path.waypoints.push_back(start);
+    for (int steps = 0; current != goalIndex; ++steps) {
+        int best = -1;
+        double bestCost = INF, bestStep = 0.0;
+        for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+            int next = current + neighbors[i].delta;
+            if (!grid.isWalkable(next)) {
+                continue;
+            }
+            double step = neighbors[i].cost * grid.getCost(next);
+            if (step + g[next] < bestCost) {
+                best = next;
+                bestCost = step + g[next];
+                bestStep = step;
+            }
+        }
+        if (best < 0 || steps == grid.getCellCount()) {
+            path.waypoints.clear();
+            return path;
+        }
+        path.cost += bestStep;
+        current = best;
+        path.waypoints.push_back(grid.getCell(current));
+    }
+    path.found = true;
+    return path;
+}
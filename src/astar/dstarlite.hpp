@@ -0,0 +1,61 @@
+#ifndef DSTARLITE_HPP
+#define DSTARLITE_HPP
+
+#include <vector>
+
+#include "astar/astar.hpp"
+#include "astar/grid.hpp"
+#include "astar/indexedheap.hpp"
+
+#include "math/vec.hpp"
+
+// incremental replanning (D* Lite) for an agent walking to a fixed goal on a grid that changes as it goes.
+// the search runs backwards from the goal and its tree is kept between calls, so after the grid changes only
+// the cells whose distance to the goal changed are searched again instead of the whole map. the planner
+// listens to the grid, changes are picked up on the next findPath. paths are as short as those of astar()
+class DStarLite : public GridListener {
+ public:
+    DStarLite(Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i goal);
+    ~DStarLite();
+    DStarLite(const DStarLite&) = delete;
+    DStarLite& operator=(const DStarLite&) = delete;
+
+    void onCellChanged(int index) override;
+    void onGridReset() override;
+
+    // moves the start as the agent walks, the search tree is kept
+    void setStart(const Math3D::Vec3i start);
+    // a new goal makes the whole search tree useless, so the next findPath starts over
+    void setGoal(const Math3D::Vec3i goal);
+    Math3D::Vec3i getStart() const;
+    Math3D::Vec3i getGoal() const;
+
+    // repairs the search tree around the cells changed since the last call and returns the path from start to goal
+    Path findPath();
+ private:
+    struct Key {
+        double primary, secondary;
+        bool operator<(const Key& other) const {
+            return primary < other.primary || (primary == other.primary && secondary < other.secondary);
+        }
+    };
+
+    Grid& grid;
+    Math3D::Vec3i start, goal;
+    int startIndex, goalIndex;
+    Math3D::Vec3i last; // start when keyOffset was last brought up to date
+    double keyOffset; // total heuristic drop from moving the start, added to new keys so queued keys stay lower bounds
+    std::vector<double> g, rhs; // cost to the goal, and the one step lookahead of it
+    IndexedHeap<Key> open; // cells where g and rhs differ
+    std::vector<int> changed;
+    bool reset;
+
+    void initialize();
+    double heuristic(int index) const;
+    Key calculateKey(int index) const;
+    double computeRhs(int index) const;
+    void updateVertex(int index);
+    void computeShortestPath();
+};
+
+#endif
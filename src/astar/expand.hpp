@@ -0,0 +1,58 @@
+#ifndef EXPAND_HPP
+#define EXPAND_HPP
+
+#include "astar/grid.hpp"
+#include "astar/searcharena.hpp"
+
+#include "math/vec.hpp"
+
+// the expansion step shared by the searches over the 26-connected grid: offers every walkable neighbor of
+// current a path through it and queues the neighbors that improve with f = g + heuristic(cell, index).
+// allowed(cell, index) can keep the search out of some cells. closed neighbors are skipped unless reopen is
+// set, which searches whose heuristic is not consistent need. a reverse search follows the steps
+// backwards, so a step costs the cell it leaves instead of the one it enters. relaxed(index) is called for
+// each neighbor whose g improved
+template <typename Heuristic, typename Allowed, typename Relaxed>
+inline void expandNeighbors(const Grid& grid, SearchArena& arena, int current, bool reverse, bool reopen,
+                            const Heuristic& heuristic, const Allowed& allowed, const Relaxed& relaxed) {
+    // the padding is never walkable, so neighbors are found by index alone with no bounds checks
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    Math3D::Vec3i cell = grid.getCell(current);
+    double g = arena.getG(current);
+    for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+        const GridNeighbor& neighbor = neighbors[i];
+        int index = current + neighbor.delta;
+        if (!grid.isWalkable(index) || (!reopen && arena.isClosed(index))) {
+            continue;
+        }
+        Math3D::Vec3i next = cell + Math3D::Vec3i(neighbor.dx, neighbor.dy, neighbor.dz);
+        if (!allowed(next, index)) {
+            continue;
+        }
+        double newG = g + neighbor.cost * grid.getCost(reverse ? current : index);
+        // checked first so the heuristic is only worked out for neighbors that improve
+        if (arena.improves(index, newG) && arena.relax(index, newG, current, newG + heuristic(next, index))) {
+            relaxed(index);
+        }
+    }
+}
+
+// lets every cell in, for expandNeighbors
+struct AnyCell {
+    bool operator()(const Math3D::Vec3i, int) const {
+        return true;
+    }
+};
+
+// ignores relaxed cells, for expandNeighbors
+struct IgnoreRelaxed {
+    void operator()(int) const {}
+};
+
+// a forward search over the whole grid that never reopens closed cells
+template <typename Heuristic>
+inline void expandNeighbors(const Grid& grid, SearchArena& arena, int current, const Heuristic& heuristic) {
+    expandNeighbors(grid, arena, current, false, false, heuristic, AnyCell(), IgnoreRelaxed());
+}
+
+#endif
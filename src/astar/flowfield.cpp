@@ -0,0 +1,195 @@
+#include "astar/flowfield.hpp"
+
+#include <algorithm>
+#include <thread>
+
+using namespace Math3D;
+
+namespace {
+    const std::uint8_t NONE = 0xff; // no direction, at goals and cells that reach none
+
+    // runs function(i) for i in [0, count), each on its own thread with the caller taking 0
+    template <typename Function>
+    void parallel(unsigned int count, const Function& function) {
+        std::vector<std::thread> helpers;
+        for (unsigned int i = 1; i < count; ++i) {
+            helpers.push_back(std::thread(function, i));
+        }
+        function(0);
+        for (unsigned int i = 0; i < helpers.size(); ++i) {
+            helpers[i].join();
+        }
+    }
+}
+
+FlowField::FlowField(const Grid& grid, unsigned int threads) : grid(grid), threads(threads) {
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+        for (int j = 0; j < Grid::NEIGHBOR_COUNT; ++j) {
+            if (neighbors[j].delta == -neighbors[i].delta) {
+                opposite[i] = j;
+            }
+        }
+    }
+}
+
+void FlowField::build(const Vec3i goal) {
+    build(std::vector<Vec3i>(1, goal));
+}
+
+/*
+The grid is cut into slabs of y layers, one per thread. In each round every slab with new seeds runs
+Dijkstra over its own cells only, then every slab looks across its borders for neighbors that give its
+cells a better distance, which become the seeds of the next round. Each phase only writes the cells of
+its own slab, so the threads never touch the same cells at once. Rounds stop when no border improves
+anything, at which point every cell has its shortest distance, the same one a single Dijkstra gives.
+*/
+void FlowField::build(const std::vector<Vec3i>& goals) {
+    int cellCount = grid.getCellCount();
+    distances.assign(cellCount, INF);
+    directions.assign(cellCount, NONE);
+    if (cellCount == 0) {
+        return;
+    }
+
+    Vec3i extents = grid.getExtents();
+    int layers = 2*extents[1] + 1;
+    unsigned int count = threads == 0 ? std::thread::hardware_concurrency() : threads;
+    count = std::max(1u, std::min(count, (unsigned int) layers));
+    std::vector<Slab> slabs(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        Slab& slab = slabs[i];
+        slab.firstY = -extents[1] + layers * i / count;
+        slab.lastY = -extents[1] + layers * (i + 1) / count - 1;
+        slab.begin = grid.getIndex(-extents[0], slab.firstY, -extents[2]);
+        slab.end = grid.getIndex(extents[0], slab.lastY, extents[2]) + 1;
+        slab.open.reset(slab.end - slab.begin);
+    }
+    for (unsigned int i = 0; i < goals.size(); ++i) {
+        int index = grid.getIndex(goals[i][0], goals[i][1], goals[i][2]);
+        if (index < 0 || !grid.isWalkable(index)) {
+            continue;
+        }
+        for (unsigned int j = 0; j < count; ++j) {
+            if (index >= slabs[j].begin && index < slabs[j].end) {
+                slabs[j].seeds.push_back(Seed{index, 0.0, NONE});
+            }
+        }
+    }
+
+    bool seeded = true;
+    while (seeded) {
+        parallel(count, [&](unsigned int i) { flood(slabs[i]); });
+        if (count == 1) {
+            break;
+        }
+        parallel(count, [&](unsigned int i) { collectSeeds(slabs[i]); });
+        seeded = false;
+        for (unsigned int i = 0; i < count; ++i) {
+            seeded = seeded || !slabs[i].seeds.empty();
+        }
+    }
+}
+
+void FlowField::flood(Slab& slab) {
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    IndexedHeap<double>& open = slab.open;
+    for (unsigned int i = 0; i < slab.seeds.size(); ++i) {
+        const Seed& seed = slab.seeds[i];
+        if (seed.distance < distances[seed.index]) {
+            distances[seed.index] = seed.distance;
+            directions[seed.index] = seed.direction;
+            int id = seed.index - slab.begin;
+            if (open.contains(id)) {
+                open.decrease(id, seed.distance);
+            } else {
+                open.push(id, seed.distance);
+            }
+        }
+    }
+    slab.seeds.clear();
+
+    // backwards from the cells closest to a goal, a step from a neighbor into the current cell costs the current cell's cost
+    while (!open.empty()) {
+        int current = open.pop() + slab.begin;
+        double stepCost = grid.getCost(current);
+        for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+            int previous = current + neighbors[i].delta;
+            if (previous < slab.begin || previous >= slab.end || !grid.isWalkable(previous)) {
+                continue;
+            }
+            double distance = distances[current] + neighbors[i].cost * stepCost;
+            if (distance < distances[previous]) {
+                distances[previous] = distance;
+                directions[previous] = opposite[i];
+                int id = previous - slab.begin;
+                if (open.contains(id)) {
+                    open.decrease(id, distance);
+                } else {
+                    open.push(id, distance);
+                }
+            }
+        }
+    }
+}
+
+void FlowField::collectSeeds(Slab& slab) const {
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    Vec3i extents = grid.getExtents();
+    for (int y = slab.firstY; y <= slab.lastY; y += std::max(1, slab.lastY - slab.firstY)) {
+        for (int x = -extents[0]; x <= extents[0]; x++) {
+            for (int z = -extents[2]; z <= extents[2]; z++) {
+                int index = grid.getIndex(x, y, z);
+                if (!grid.isWalkable(index)) {
+                    continue;
+                }
+                Seed seed{index, distances[index], NONE};
+                for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+                    int next = index + neighbors[i].delta;
+                    if ((next >= slab.begin && next < slab.end) || !grid.isWalkable(next)) {
+                        continue;
+                    }
+                    double distance = distances[next] + neighbors[i].cost * grid.getCost(next);
+                    if (distance < seed.distance) {
+                        seed.distance = distance;
+                        seed.direction = i;
+                    }
+                }
+                if (seed.direction != NONE) {
+                    slab.seeds.push_back(seed);
+                }
+            }
+        }
+    }
+}
+
+double FlowField::getDistance(const Vec3i cell) const {
+    int index = grid.getIndex(cell[0], cell[1], cell[2]);
+    return index < 0 || distances.empty() ? INF : distances[index];
+}
+
+Vec3i FlowField::getDirection(const Vec3i cell) const {
+    int index = grid.getIndex(cell[0], cell[1], cell[2]);
+    if (index < 0 || directions.empty() || directions[index] == NONE) {
+        return Vec3i();
+    }
+    const GridNeighbor& neighbor = grid.getNeighbors()[directions[index]];
+    return Vec3i(neighbor.dx, neighbor.dy, neighbor.dz);
+}
+
+Path FlowField::getPath(const Vec3i start) const {
+    Path path;
+    int index = grid.getIndex(start[0], start[1], start[2]);
+    if (index < 0 || distances.empty() || distances[index] == INF) {
+        return path;
+    }
+    path.found = true;
+    path.cost = distances[index];
+    path.waypoints.push_back(start);
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    while (directions[index] != NONE) {
+        index += neighbors[directions[index]].delta;
+        path.waypoints.push_back(grid.getCell(index));
+    }
+    return path;
+}
@@ -0,0 +1,59 @@
+#ifndef FLOWFIELD_HPP
+#define FLOWFIELD_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "astar/astar.hpp"
+#include "astar/grid.hpp"
+#include "astar/indexedheap.hpp"
+
+#include "math/vec.hpp"
+
+// a flow field (Dijkstra map) towards one or more goal cells: the cost of the cheapest path from every cell
+// to its nearest goal, and the first step of that path. one build serves any number of agents heading to the
+// same goals, each step of each agent is then a single lookup. the field is a snapshot, it has to be built
+// again after the grid changes
+class FlowField {
+ public:
+    // threads is the number of threads a build uses including the caller, 0 uses every core
+    FlowField(const Grid& grid, unsigned int threads = 0);
+
+    // floods out from the walkable goals, replacing the field. the grid must not change meanwhile
+    void build(const std::vector<Math3D::Vec3i>& goals);
+    void build(const Math3D::Vec3i goal);
+
+    // these only read and can be called from any thread
+    // cost of the cheapest path from the cell to a goal, infinite when there is none
+    double getDistance(const Math3D::Vec3i cell) const;
+    // the step to take from the cell, (0, 0, 0) at a goal and where no goal can be reached
+    Math3D::Vec3i getDirection(const Math3D::Vec3i cell) const;
+    // the whole path from start to the nearest goal, by following the directions
+    Path getPath(const Math3D::Vec3i start) const;
+ private:
+    // a better distance for a cell found from a neighboring slab, with the step towards that neighbor
+    struct Seed {
+        int index;
+        double distance;
+        std::uint8_t direction;
+    };
+
+    // a range of y layers, which is a contiguous range of cell indices
+    struct Slab {
+        int firstY, lastY;
+        int begin, end;
+        std::vector<Seed> seeds;
+        IndexedHeap<double> open; // by index - begin
+    };
+
+    const Grid& grid;
+    unsigned int threads;
+    std::vector<double> distances;
+    std::vector<std::uint8_t> directions; // a neighbor in getNeighbors() order, or NONE
+    int opposite[Grid::NEIGHBOR_COUNT];
+
+    void flood(Slab& slab);
+    void collectSeeds(Slab& slab) const;
+};
+
+#endif
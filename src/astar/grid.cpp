@@ -1,127 +1,217 @@
 #include "astar/grid.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace Math3D;
 
 Grid::Grid() {
-    grid = nullptr;
-    width = height = depth = 0;
+    create(0, 0, 0);
+    walkable.clear();
 }
 
 Grid::Grid(int x, int y, int z) {
-    int halfW, halfH, halfD;
-    halfW = x;
-    halfH = y;
-    halfD = z;
-    width = x * 2;
-    height = y * 2;
-    depth = z * 2;
-    grid = new Node*[(width + 1) * (height + 1) * (depth + 1)];
-    for (x = -halfW; x <= halfW; x++) {
-        for (y = -halfH; y <= halfH ; y++) {
-            for (z = -halfD; z <= halfD; z++) {
-                grid[(y + halfH)*(width+1)*(depth+1) + (x + halfW)*(depth+1) + z + halfD] = nullptr;
-            }
-        }
-    }
+    create(x, y, z);
 }
 
 Grid::~Grid() {
     destroy();
 }
 
-void Grid::destroy() {
-    if (grid != nullptr) {
-        int halfW, halfH, halfD;
-        halfW = width / 2;
-        halfH = height / 2;
-        halfD = depth / 2;
-        Node* node;
-        for (int x = -halfW; x <= halfW; x++) {
-            for (int y = -halfH; y <= halfH ; y++) {
-                for (int z = -halfD; z <= halfD; z++) {
-                    node = getNode(x, y, z);
-                    if (node != nullptr) {
-                        delete node;
-                    }
+void Grid::create(int halfW, int halfH, int halfD) {
+    width = halfW * 2;
+    height = halfH * 2;
+    depth = halfD * 2;
+    strideX = depth + 3;
+    strideY = (width + 3) * strideX;
+    int count = (height + 3) * strideY;
+    walkable.assign((count + 63) / 64, 0); // every cell starts blocked, the padding is never unblocked
+
+    int n = 0;
+    for (int x = -1; x <= 1; x++) {
+        for (int y = -1; y <= 1; y++) {
+            for (int z = -1; z <= 1; z++) {
+                if (x != 0 || y != 0 || z != 0) {
+                    GridNeighbor& neighbor = neighbors[n++];
+                    neighbor.dx = x;
+                    neighbor.dy = y;
+                    neighbor.dz = z;
+                    neighbor.delta = y*strideY + x*strideX + z;
+                    neighbor.cost = std::sqrt((double) (x*x + y*y + z*z));
                 }
             }
         }
-        delete[] grid;
     }
 }
 
+void Grid::destroy() {
+    for (std::unordered_map<int, Node*>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        delete it->second;
+    }
+    nodes.clear();
+    walkable.clear();
+    costs.clear();
+}
+
+void Grid::setWalkable(int x, int y, int z, bool walk) {
+    int index = getIndex(x, y, z);
+    if (index < 0) {
+        return;
+    }
+    std::uint64_t bit = std::uint64_t(1) << (index & 63);
+    if (isWalkable(index) != walk) {
+        walkable[index >> 6] ^= bit;
+        notify(index);
+    }
+    if (!walk) {
+        std::unordered_map<int, Node*>::iterator it = nodes.find(index);
+        if (it != nodes.end()) {
+            delete it->second;
+            nodes.erase(it);
+        }
+    }
+}
+
+bool Grid::isWalkable(int x, int y, int z) const {
+    int index = getIndex(x, y, z);
+    return index >= 0 && isWalkable(index);
+}
+
+void Grid::setCost(int x, int y, int z, std::uint8_t cost) {
+    int index = getIndex(x, y, z);
+    if (index < 0) {
+        return;
+    }
+    if (costs.empty()) {
+        costs.assign(getCellCount(), 1);
+    }
+    cost = cost == 0 ? 1 : cost;
+    if (costs[index] != cost) {
+        costs[index] = cost;
+        notify(index);
+    }
+}
+
+bool Grid::hasCosts() const {
+    return !costs.empty();
+}
+
 void Grid::setNode(int x, int y, int z, Node* node) {
-    int halfW, halfH, halfD;
-    halfW = width / 2;
-    halfH = height / 2;
-    halfD = depth / 2;
-    x = x + halfW;
-    y = y + halfH;
-    z = z + halfD;
-    grid[y*(width+1)*(depth+1) + x*(depth+1) + z] = node;
+    int index = getIndex(x, y, z);
+    if (index < 0) {
+        delete node;
+        return;
+    }
+    setWalkable(x, y, z, node != nullptr); // blocking deletes the old node
+    if (node != nullptr) {
+        Node*& slot = nodes[index];
+        if (slot != node) {
+            delete slot;
+        }
+        slot = node;
+    }
 }
 
 Node* Grid::getNode(int x, int y, int z) const {
-    int halfW, halfH, halfD;
-    halfW = width / 2;
-    halfH = height / 2;
-    halfD = depth / 2;
-    if (x < -halfW || x > halfW || y < -halfH || y > halfH || z < -halfD || z > halfD) {
+    int index = getIndex(x, y, z);
+    if (index < 0) {
         return nullptr;
     }
-    x = x + halfW;
-    y = y + halfH;
-    z = z + halfD;
-    return grid[y*(width+1)*(depth+1) + x*(depth+1) + z];
+    return getNode(index);
 }
 
 Node* Grid::getNode(const Vector4 pos) const {
-    int x, y, z;
-    x = floor(pos[0] + 0.5);
-    y = floor(pos[1] + 0.5);
-    z = floor(pos[2] + 0.5);
+    int index = getIndex(pos);
+    if (index < 0) {
+        return nullptr;
+    }
+    return getNode(index);
+}
+
+Node* Grid::getNode(int index) const {
+    if (!isWalkable(index)) {
+        return nullptr;
+    }
+    Node*& node = nodes[index];
+    if (node == nullptr) { // walkable through setWalkable or load, made on first use like load used to
+        Vec3i cell = getCell(index);
+        node = new Node(Vector4(cell[0], cell[1], cell[2]));
+    }
+    return node;
+}
+
+int Grid::getIndex(int x, int y, int z) const {
     int halfW, halfH, halfD;
     halfW = width / 2;
     halfH = height / 2;
     halfD = depth / 2;
-    if (x < -halfW || x > halfW || y < -halfH || y > halfH || z < -halfD || z > halfD) {
-        return nullptr;
+    if (walkable.empty() || x < -halfW || x > halfW || y < -halfH || y > halfH || z < -halfD || z > halfD) {
+        return -1;
     }
-    x = x + halfW;
-    y = y + halfH;
-    z = z + halfD;
-    return grid[y*(width+1)*(depth+1) + x*(depth+1) + z];
+    x = x + halfW + 1;
+    y = y + halfH + 1;
+    z = z + halfD + 1;
+    return y*strideY + x*strideX + z;
 }
 
-void Grid::load(std::istream& ins) {
-    if (grid != nullptr) {
-        destroy();
+int Grid::getIndex(const Vector4 pos) const {
+    return getIndex((int) floor(pos[0] + 0.5), (int) floor(pos[1] + 0.5), (int) floor(pos[2] + 0.5));
+}
+
+Vec3i Grid::getCell(int index) const {
+    int z = index % strideX;
+    index /= strideX;
+    int x = index % (width + 3);
+    int y = index / (width + 3);
+    return Vec3i(x - 1 - width / 2, y - 1 - height / 2, z - 1 - depth / 2);
+}
+
+int Grid::getCellCount() const {
+    if (walkable.empty()) {
+        return 0;
     }
-    ins >> width >> height >> depth;
+    return (height + 3) * strideY;
+}
+
+Vec3i Grid::getExtents() const {
+    return Vec3i(width / 2, height / 2, depth / 2);
+}
+
+void Grid::addListener(GridListener* listener) {
+    listeners.push_back(listener);
+}
+
+void Grid::removeListener(GridListener* listener) {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+void Grid::notify(int index) {
+    for (unsigned int i = 0; i < listeners.size(); ++i) {
+        listeners[i]->onCellChanged(index);
+    }
+}
+
+void Grid::load(std::istream& ins) {
+    destroy();
     int halfW, halfH, halfD;
-    halfW = width;
-    halfH = height;
-    halfD = depth; 
-    width *= 2;
-    height *= 2;
-    depth *= 2;
-
-    grid = new Node*[(width + 1) * (height + 1) * (depth + 1)];
+    ins >> halfW >> halfH >> halfD;
+    create(halfW, halfH, halfD);
+
     bool b;
     for (int x = -halfW; x <= halfW; x++) {
         for (int y = -halfH; y <= halfH ; y++) {
             for (int z = -halfD; z <= halfD; z++) {
                 ins >> b;
-                if (b) {
-                    setNode(x, y, z, nullptr);
-                } else {
-                    setNode(x, y, z, new Node(Vector4(x, y, z)));
+                if (!b) {
+                    int index = getIndex(x, y, z);
+                    walkable[index >> 6] |= std::uint64_t(1) << (index & 63);
                 }
             }
         }
     }
+    for (unsigned int i = 0; i < listeners.size(); ++i) {
+        listeners[i]->onGridReset();
+    }
 }
 
 void Grid::save(std::ostream& outs) {
@@ -130,14 +220,14 @@ void Grid::save(std::ostream& outs) {
     halfH = height / 2;
     halfD = depth / 2; 
     outs << halfW << std::endl << halfH << std::endl << halfD << std::endl;
-    if (grid == nullptr) {
+    if (walkable.empty()) {
         return;
     }
 
     for (int x = -halfW; x <= halfW; x++) {
         for (int y = -halfH; y <= halfH ; y++) {
             for (int z = -halfD; z <= halfD; z++) {
-                outs << (getNode(x, y, z) == nullptr);
+                outs << !isWalkable(x, y, z);
                 if (halfH == halfH - 1 && halfD == halfD - 1) {
                     outs << std::endl;
                 } else {
@@ -146,4 +236,4 @@ void Grid::save(std::ostream& outs) {
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -1,26 +1,126 @@
 #ifndef GRID_HPP
 #define GRID_HPP
 
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 #include "astar/node.hpp"
 
+#include "math/vec.hpp"
 #include "math/vector4.hpp"
 
+// one of the 26 neighbors of a cell, delta is the difference in linear index
+struct GridNeighbor {
+    int dx, dy, dz;
+    int delta;
+    double cost; // step length, 1, sqrt 2 or sqrt 3
+};
+
+// the cost of a cell no path reaches
+const double INF = std::numeric_limits<double>::infinity();
+
+// straight line distance between two cells, no path between them costs less
+inline double distance(const Math3D::Vec3i a, const Math3D::Vec3i b) {
+    Math3D::Vec3i d = a - b;
+    return std::sqrt((double) d.dot(d));
+}
+
+// gets told about changes to a Grid it has been added to, for structures built on top of the grid
+class GridListener {
+ public:
+    virtual ~GridListener() {}
+    // the walkability or cost of the cell changed
+    virtual void onCellChanged(int index) = 0;
+    // the whole grid was replaced, by load
+    virtual void onGridReset() = 0;
+};
+
+// a box of cells from (-x, -y, -z) to (x, y, z). walkability is stored as one bit per cell with an
+// optional byte per cell of traversal cost, cell positions come from their index so nothing is
+// allocated per cell. the cells are surrounded by a border of blocked padding cells, so the
+// neighbors of any cell inside the grid can be reached by adding a delta to its index without
+// checking bounds
 class Grid {
  public:
+    static const int NEIGHBOR_COUNT = 26;
+
     Grid();
     Grid(int x, int y, int z);
     ~Grid();
+    Grid(const Grid&) = delete;
+    Grid& operator=(const Grid&) = delete;
+
+    void setWalkable(int x, int y, int z, bool walkable);
+    bool isWalkable(int x, int y, int z) const;
+    bool isWalkable(int index) const {
+        return (walkable[index >> 6] >> (index & 63)) & 1;
+    }
+    // bit i is set when neighbor i (in getNeighbors() order) is walkable, the cell must be inside the grid
+    std::uint32_t getWalkableNeighbors(int index) const {
+        std::uint32_t bits = 0;
+        int shift = 0;
+        for (int x = -1; x <= 1; x++) {
+            for (int y = -1; y <= 1; y++) {
+                // the three z neighbors are adjacent bits, possibly split between two words
+                int first = index + y*strideY + x*strideX - 1;
+                std::uint64_t word = walkable[first >> 6] >> (first & 63);
+                if ((first & 63) > 61) {
+                    word |= walkable[(first >> 6) + 1] << (64 - (first & 63));
+                }
+                bits |= (std::uint32_t) (word & 7) << shift;
+                shift += 3;
+            }
+        }
+        return (bits & 0x1fff) | ((bits >> 1) & ~0x1fffu); // drop bit 13, the cell itself
+    }
+    // costs multiply the length of every step into the cell, they are all 1 until the first setCost
+    // and a cost of 0 is stored as 1 so the Euclidean heuristic stays admissible
+    void setCost(int x, int y, int z, std::uint8_t cost);
+    std::uint8_t getCost(int index) const {
+        return costs.empty() ? 1 : costs[index];
+    }
+    bool hasCosts() const;
+
+    // Node adapter for older code: setNode marks the cell walkable (or blocked for nullptr) and the grid
+    // takes ownership of the node. getNode returns nullptr for blocked cells, and for walkable ones the node
+    // given to setNode or else one at the cell position made on first use, so it is not safe to call from
+    // several threads at once
     void setNode(int x, int y, int z, Node* node);
     Node* getNode(int x, int y, int z) const;
     Node* getNode(const Math3D::Vector4 pos) const;
+    Node* getNode(int index) const;
+
+    // linear cell index in [0, getCellCount()), or -1 when outside the grid. getCellCount includes the padding
+    int getIndex(int x, int y, int z) const;
+    int getIndex(const Math3D::Vector4 pos) const;
+    Math3D::Vec3i getCell(int index) const;
+    int getCellCount() const;
+    // the x, y and z given to the constructor, cells go from -extents to extents
+    Math3D::Vec3i getExtents() const;
+    // the NEIGHBOR_COUNT neighbor steps, the deltas are only valid for indices of cells inside the grid
+    const GridNeighbor* getNeighbors() const {
+        return neighbors;
+    }
+    // listeners are not owned and must be removed before they are destroyed
+    void addListener(GridListener* listener);
+    void removeListener(GridListener* listener);
     void load(std::istream& ins);
     void save(std::ostream& outs);
  private:
-    Node** grid;
+    std::vector<std::uint64_t> walkable;
+    std::vector<std::uint8_t> costs;
+    mutable std::unordered_map<int, Node*> nodes; // filled in lazily by getNode
+    std::vector<GridListener*> listeners;
     int width, height, depth;
+    int strideX, strideY; // index deltas for a step in x and y, a step in z is 1
+    GridNeighbor neighbors[NEIGHBOR_COUNT];
+    void create(int halfW, int halfH, int halfD);
     void destroy();
+    void notify(int index);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,331 @@
+#include "astar/hdastar.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using std::size_t;
+using namespace Math3D;
+
+namespace {
+    // a cell reached with cost g through parent, sent to the thread owning the cell
+    struct Message {
+        int index;
+        int parent;
+        double g;
+    };
+
+    // fixed size ring with one producer and one consumer thread, neither ever blocks
+    class MessageQueue {
+     public:
+        MessageQueue() : slots(CAPACITY), head(0), tail(0) {}
+
+        // returns false when full
+        bool push(const Message& message) {
+            size_t back = tail.load(std::memory_order_relaxed);
+            if (back - head.load(std::memory_order_acquire) == CAPACITY) {
+                return false;
+            }
+            slots[back & (CAPACITY - 1)] = message;
+            tail.store(back + 1, std::memory_order_release);
+            return true;
+        }
+        // only while neither thread uses the queue
+        void clear() {
+            head.store(0);
+            tail.store(0);
+        }
+        // returns false when empty
+        bool pop(Message& message) {
+            size_t front = head.load(std::memory_order_relaxed);
+            if (front == tail.load(std::memory_order_acquire)) {
+                return false;
+            }
+            message = slots[front & (CAPACITY - 1)];
+            head.store(front + 1, std::memory_order_release);
+            return true;
+        }
+     private:
+        static const size_t CAPACITY = 1024; // a power of 2
+
+        std::vector<Message> slots;
+        alignas(64) std::atomic<size_t> head;
+        alignas(64) std::atomic<size_t> tail;
+    };
+
+    // a cell on the open set of a thread. a cell is queued again instead of moved up when its g is lowered, so
+    // entries whose g is no longer the cell's are stale and skipped
+    struct OpenEntry {
+        double f;
+        double g;
+        int index;
+
+        bool operator<(const OpenEntry& b) const {
+            return f > b.f; // lowest f on top of the heap
+        }
+    };
+}
+
+struct HdaArena::State {
+    struct Cell {
+        double g;
+        int parent;
+        unsigned int generation;
+    };
+
+    std::vector<Cell> cells;
+    unsigned int generation;
+    std::vector<std::vector<OpenEntry> > opens; // one per thread, only its own cells are queued
+    std::vector<MessageQueue> queues; // from thread a to thread b at a * threads + b
+
+    State() : generation(0) {}
+
+    void begin(int cellCount, unsigned int threads) {
+        if ((int) cells.size() != cellCount) {
+            cells.assign(cellCount, Cell());
+            generation = 0;
+        }
+        generation++;
+        if (generation == 0) { // stamps wrapped around, old stamps could look current
+            cells.assign(cellCount, Cell());
+            generation = 1;
+        }
+        opens.resize(threads);
+        for (unsigned int i = 0; i < threads; ++i) {
+            opens[i].clear();
+        }
+        if (queues.size() != threads * threads) {
+            std::vector<MessageQueue>(threads * threads).swap(queues);
+        } else {
+            for (unsigned int i = 0; i < queues.size(); ++i) {
+                queues[i].clear();
+            }
+        }
+    }
+
+    double getG(int index) const {
+        return cells[index].generation == generation ? cells[index].g : INF;
+    }
+    int getParent(int index) const {
+        return cells[index].generation == generation ? cells[index].parent : -1;
+    }
+    void visit(int index, double g, int parent) {
+        Cell& cell = cells[index];
+        cell.g = g;
+        cell.parent = parent;
+        cell.generation = generation;
+    }
+};
+
+HdaArena::HdaArena() : state(new State()) {}
+
+HdaArena::~HdaArena() {}
+
+namespace {
+    /*
+    What the threads of one search share. g and parent of a cell, in the arena, are only touched by its owner.
+
+    The search is over once no thread has a cell with f below the best cost found for end and no message
+    is in flight. inFlight counts messages from before they are queued until the thread that got them next
+    runs out of work, and a thread can only get new work from a message, so inFlight reaching 0 means every
+    thread is out of work for good.
+    */
+    struct Search {
+        Search(const Grid& grid, const Vec3i end, unsigned int threads, HdaArena::State& arena) :
+            grid(grid), end(end), endIndex(grid.getIndex(end[0], end[1], end[2])), threads(threads), arena(arena),
+            best(INF), inFlight(0), done(false) {}
+
+        unsigned int getOwner(int index) const {
+            return ((unsigned int) index * 2654435761u >> 8) % threads;
+        }
+
+        const Grid& grid;
+        Vec3i end;
+        int endIndex;
+        unsigned int threads;
+        HdaArena::State& arena;
+        std::atomic<double> best; // cost of the best path to end so far
+        std::atomic<long> inFlight;
+        std::atomic<bool> done;
+    };
+
+    class Worker {
+     public:
+        Worker(Search& search, unsigned int self) :
+            search(search), self(self), open(search.arena.opens[self]), outboxes(search.threads), sent(0),
+            received(0) {}
+
+        // the owner of start has counted start as a received message
+        void start(int startIndex) {
+            received = 1;
+            relax(Message{startIndex, -1, 0.0});
+        }
+
+        void run() {
+            const Grid& grid = search.grid;
+            const GridNeighbor* neighbors = grid.getNeighbors();
+            HdaArena::State& arena = search.arena;
+            while (!search.done.load()) {
+                bool working = false;
+                Message message;
+                for (unsigned int from = 0; from < search.threads; ++from) {
+                    MessageQueue& queue = arena.queues[from * search.threads + self];
+                    while (queue.pop(message)) {
+                        received++;
+                        relax(message);
+                        working = true;
+                    }
+                }
+
+                // a thread that cannot hand its messages over waits instead of running ahead with costs the
+                // others are about to lower, which would only mean expanding the same cells again later
+                if (flush()) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                // a batch of expansions between checks of the queues
+                double best = search.best.load();
+                for (int n = 0; n < 32 && dropStale() && open.front().f < best; ++n) {
+                    std::pop_heap(open.begin(), open.end());
+                    int current = open.back().index;
+                    open.pop_back();
+                    double g = arena.getG(current);
+                    int parent = arena.getParent(current);
+                    for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+                        const GridNeighbor& neighbor = neighbors[i];
+                        int index = current + neighbor.delta;
+                        if (!grid.isWalkable(index) || index == parent) {
+                            continue;
+                        }
+                        Message next{index, current, g + neighbor.cost * grid.getCost(index)};
+                        unsigned int owner = search.getOwner(index);
+                        if (owner == self) {
+                            relax(next);
+                        } else {
+                            outboxes[owner].push_back(next);
+                            sent++;
+                        }
+                    }
+                    working = true;
+                }
+                if (flush() || working) {
+                    continue;
+                }
+
+                if (received > 0) {
+                    search.inFlight.fetch_sub(received);
+                    received = 0;
+                }
+                if (search.inFlight.load() == 0) {
+                    search.done.store(true);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+     private:
+        Search& search;
+        unsigned int self;
+        std::vector<OpenEntry>& open; // a heap
+        std::vector<std::vector<Message> > outboxes; // messages waiting for room in the queue to each thread
+        long sent, received;
+
+        // moves what fits from the outboxes to the queues, returns true if some messages are still waiting
+        bool flush() {
+            if (sent > 0) {
+                search.inFlight.fetch_add(sent);
+                sent = 0;
+            }
+            bool waiting = false;
+            for (unsigned int to = 0; to < search.threads; ++to) {
+                std::vector<Message>& outbox = outboxes[to];
+                MessageQueue& queue = search.arena.queues[self * search.threads + to];
+                size_t count = 0;
+                while (count < outbox.size() && queue.push(outbox[count])) {
+                    count++;
+                }
+                outbox.erase(outbox.begin(), outbox.begin() + count);
+                waiting = waiting || !outbox.empty();
+            }
+            return waiting;
+        }
+
+        // pops stale entries off the top of the open set, returns false if it is empty
+        bool dropStale() {
+            while (!open.empty() && open.front().g != search.arena.getG(open.front().index)) {
+                std::pop_heap(open.begin(), open.end());
+                open.pop_back();
+            }
+            return !open.empty();
+        }
+
+        void relax(const Message& message) {
+            HdaArena::State& arena = search.arena;
+            if (message.g >= arena.getG(message.index)) {
+                return;
+            }
+            arena.visit(message.index, message.g, message.parent);
+            if (message.index == search.endIndex) {
+                double best = search.best.load();
+                while (message.g < best && !search.best.compare_exchange_weak(best, message.g)) {}
+                return;
+            }
+            double f = message.g + distance(search.grid.getCell(message.index), search.end);
+            open.push_back(OpenEntry{f, message.g, message.index});
+            std::push_heap(open.begin(), open.end());
+        }
+    };
+}
+
+Path hdaStar(const Grid& grid, const Vec3i start, const Vec3i end, HdaArena& arena, unsigned int threads) {
+    Path path;
+    int startIndex = grid.getIndex(start[0], start[1], start[2]);
+    int endIndex = grid.getIndex(end[0], end[1], end[2]);
+    if (startIndex < 0 || endIndex < 0 || !grid.isWalkable(startIndex) || !grid.isWalkable(endIndex)) {
+        return path;
+    }
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads <= 1 || startIndex == endIndex) {
+        return astar(grid, start, end);
+    }
+
+    HdaArena::State& state = *arena.state;
+    state.begin(grid.getCellCount(), threads);
+    Search search(grid, end, threads, state);
+    std::vector<Worker> workers;
+    workers.reserve(threads);
+    for (unsigned int i = 0; i < threads; ++i) {
+        workers.push_back(Worker(search, i));
+    }
+    search.inFlight = 1;
+    workers[search.getOwner(startIndex)].start(startIndex);
+    std::vector<std::thread> helpers;
+    for (unsigned int i = 1; i < threads; ++i) {
+        helpers.push_back(std::thread(&Worker::run, &workers[i]));
+    }
+    workers[0].run();
+    for (unsigned int i = 0; i < helpers.size(); ++i) {
+        helpers[i].join();
+    }
+
+    if (state.getG(endIndex) == INF) {
+        return path;
+    }
+    path.found = true;
+    path.cost = state.getG(endIndex);
+    for (int index = endIndex; index >= 0; index = state.getParent(index)) {
+        path.waypoints.push_back(grid.getCell(index));
+    }
+    std::reverse(path.waypoints.begin(), path.waypoints.end());
+    return path;
+}
+
+Path hdaStar(const Grid& grid, const Vec3i start, const Vec3i end, unsigned int threads) {
+    HdaArena arena;
+    return hdaStar(grid, start, end, arena, threads);
+}
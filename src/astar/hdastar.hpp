@@ -0,0 +1,41 @@
+#ifndef HDASTAR_HPP
+#define HDASTAR_HPP
+
+#include <memory>
+
+#include "astar/astar.hpp"
+#include "astar/grid.hpp"
+
+#include "math/vec.hpp"
+
+class HdaArena;
+
+// hash distributed A* (HDA*), one search spread over several threads. every cell is owned by one thread
+// picked by hashing its index, each thread keeps the open set of its own cells and sends the cells it
+// reaches to their owners through lock-free queues. cells can be expanded more than once, but the result
+// has the same cost as astar(). the threads are started per call, which is only worth it for a single long
+// query, batches of queries are better spread across a PathFinder. threads includes the caller, 0 uses
+// every core. the arena keeps the memory of the search between calls, without it every call allocates it
+Path hdaStar(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end, HdaArena& arena,
+             unsigned int threads = 0);
+Path hdaStar(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end, unsigned int threads = 0);
+
+// what SearchArena is to astar() for hdaStar: g and parent of every cell, stamped with the search they belong
+// to so starting a search doesn't touch them, and the open sets and message queues of the threads. only one
+// search can use an arena at a time
+class HdaArena {
+ public:
+    HdaArena();
+    ~HdaArena();
+    HdaArena(const HdaArena&) = delete;
+    HdaArena& operator=(const HdaArena&) = delete;
+
+    struct State; // defined along with hdaStar
+ private:
+    std::unique_ptr<State> state;
+
+    friend Path hdaStar(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end, HdaArena& arena,
+                        unsigned int threads);
+};
+
+#endif
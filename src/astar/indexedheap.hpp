@@ -0,0 +1,150 @@
+#ifndef INDEXEDHEAP_HPP
+#define INDEXEDHEAP_HPP
+
+#include <vector>
+
+/*
+Binary min-heap of integer ids in [0, capacity) keyed by a priority of type T.
+Each id's slot in the heap is tracked so membership tests are O(1) and a
+queued id's priority can be lowered in place (decrease-key) instead of
+pushing a duplicate.
+*/
+template <typename T>
+class IndexedHeap {
+ public:
+    IndexedHeap() {}
+    explicit IndexedHeap(int capacity) : positions(capacity, -1) {}
+
+    /*
+    Empties the heap and makes room for ids in [0, capacity).
+    */
+    void reset(int capacity) {
+        heap.clear();
+        positions.assign(capacity, -1);
+    }
+    /*
+    Empties the heap, touching only the ids currently queued.
+    */
+    void clear() {
+        for (int i = 0; i < (int) heap.size(); ++i) {
+            positions[heap[i].id] = -1;
+        }
+        heap.clear();
+    }
+
+    bool empty() const { return heap.empty(); }
+    int size() const { return heap.size(); }
+    bool contains(int id) const { return positions[id] >= 0; }
+
+    int top() const { return heap[0].id; }
+    T topPriority() const { return heap[0].priority; }
+    T getPriority(int id) const { return heap[positions[id]].priority; }
+
+    /*
+    Queues an id that is not already in the heap.
+    */
+    void push(int id, T priority) {
+        Entry entry;
+        entry.id = id;
+        entry.priority = priority;
+        heap.push_back(entry);
+        positions[id] = heap.size() - 1;
+        siftUp(heap.size() - 1);
+    }
+    /*
+    Lowers the priority of a queued id, does nothing if the new priority is not lower.
+    */
+    void decrease(int id, T priority) {
+        int i = positions[id];
+        if (priority < heap[i].priority) {
+            heap[i].priority = priority;
+            siftUp(i);
+        }
+    }
+    /*
+    Sets the priority of a queued id, moving it either way.
+    */
+    void update(int id, T priority) {
+        int i = positions[id];
+        if (priority < heap[i].priority) {
+            heap[i].priority = priority;
+            siftUp(i);
+        } else {
+            heap[i].priority = priority;
+            siftDown(i);
+        }
+    }
+    /*
+    Removes and returns the id with the lowest priority.
+    */
+    int pop() {
+        int id = heap[0].id;
+        remove(id);
+        return id;
+    }
+    /*
+    Removes a queued id.
+    */
+    void remove(int id) {
+        int i = positions[id];
+        positions[id] = -1;
+        Entry last = heap.back();
+        heap.pop_back();
+        if (i < (int) heap.size()) {
+            heap[i] = last;
+            positions[last.id] = i;
+            if (i > 0 && last.priority < heap[(i - 1) / 2].priority) {
+                siftUp(i);
+            } else {
+                siftDown(i);
+            }
+        }
+    }
+ private:
+    struct Entry {
+        T priority;
+        int id;
+    };
+
+    std::vector<Entry> heap;
+    std::vector<int> positions;
+
+    void siftUp(int i) {
+        Entry entry = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!(entry.priority < heap[parent].priority)) {
+                break;
+            }
+            heap[i] = heap[parent];
+            positions[heap[i].id] = i;
+            i = parent;
+        }
+        heap[i] = entry;
+        positions[entry.id] = i;
+    }
+
+    void siftDown(int i) {
+        Entry entry = heap[i];
+        int count = heap.size();
+        while (true) {
+            int child = 2 * i + 1;
+            if (child >= count) {
+                break;
+            }
+            if (child + 1 < count && heap[child + 1].priority < heap[child].priority) {
+                child++;
+            }
+            if (!(heap[child].priority < entry.priority)) {
+                break;
+            }
+            heap[i] = heap[child];
+            positions[heap[i].id] = i;
+            i = child;
+        }
+        heap[i] = entry;
+        positions[entry.id] = i;
+    }
+};
+
+#endif
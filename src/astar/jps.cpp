@@ -0,0 +1,302 @@
+#include "astar/jps.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+
+using namespace Math3D;
+
+namespace {
+    // neighbor number (as ordered by Grid::getNeighbors) of the offset (x, y, z)
+    int neighborNumber(int x, int y, int z) {
+        int n = (x + 1)*9 + (y + 1)*3 + z + 1;
+        return n > 13 ? n - 1 : n; // (0, 0, 0) is not a neighbor
+    }
+
+    struct JumpRule {
+        int neighbor;
+        bool natural;
+        // the neighbor is forced when every witness has a blocked cell, each witness is the set of cells
+        // on a path from the parent to this neighbor that avoids the node and beats going through it
+        std::vector<std::uint32_t> witnesses;
+    };
+
+    struct Direction {
+        std::vector<JumpRule> rules; // successors worth considering after moving in this direction
+        std::vector<int> subDirections; // natural directions other than this one, scanned while jumping diagonally
+        std::uint32_t witnessCells; // a neighbor can only be forced when one of these is blocked
+    };
+
+    /*
+    Pruning rules for each of the 26 directions of arrival, worked out once from the 3x3x3 block
+    around a node n reached from its parent p. A neighbor x is pruned when some path from p to x that
+    stays in the block and avoids n beats p -> n -> x (see findWitnesses). Natural neighbors have no
+    such path and are the only successors in open space, the others are forced when obstacles block
+    every such path.
+    */
+    struct JumpTables {
+        JumpTables() {
+            Vec3i offsets[Grid::NEIGHBOR_COUNT];
+            int n = 0;
+            for (int x = -1; x <= 1; x++) {
+                for (int y = -1; y <= 1; y++) {
+                    for (int z = -1; z <= 1; z++) {
+                        if (x != 0 || y != 0 || z != 0) {
+                            offsets[n++] = Vec3i(x, y, z);
+                        }
+                    }
+                }
+            }
+
+            for (int dir = 0; dir < Grid::NEIGHBOR_COUNT; ++dir) {
+                Vec3i d = offsets[dir];
+                Vec3i parent = -d;
+                Direction& direction = directions[dir];
+                direction.witnessCells = 0;
+                for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+                    Vec3i x = offsets[i];
+                    if (x == parent) {
+                        continue;
+                    }
+                    // moving p -> n -> x, with k the number of nonzero components of each move
+                    Via via;
+                    via.cost = distance(parent, Vec3i()) + distance(Vec3i(), x);
+                    via.order = moveSize(d)*4 + moveSize(x);
+                    std::vector<std::uint32_t> found;
+                    findWitnesses(parent, x, via, 0.0, 0, 0, 1u << neighborNumber(parent[0], parent[1], parent[2]), found);
+
+                    JumpRule rule;
+                    rule.neighbor = i;
+                    rule.natural = found.empty();
+                    if (rule.natural) {
+                        if (i != dir) {
+                            direction.subDirections.push_back(i);
+                        }
+                    } else {
+                        rule.witnesses = minimal(found);
+                        if (rule.witnesses[0] == 0) {
+                            continue; // reachable straight from the parent, never a successor
+                        }
+                        for (unsigned int w = 0; w < rule.witnesses.size(); ++w) {
+                            direction.witnessCells |= rule.witnesses[w];
+                        }
+                    }
+                    direction.rules.push_back(rule);
+                }
+            }
+        }
+
+        struct Via {
+            double cost;
+            int order;
+        };
+
+        static int moveSize(const Vec3i d) {
+            return std::abs(d[0]) + std::abs(d[1]) + std::abs(d[2]);
+        }
+
+        /*
+        Records the cells in between of every path from cell to target that stays in the block, avoids its center
+        and beats the path through the center. A path beats it by being shorter, or equally long with bigger
+        moves first (order holds the move sizes as base 4 digits). Equal costs mean the same moves in some order,
+        since 1, sqrt 2 and sqrt 3 are independent, so the orders have the same number of digits.
+        Breaking ties the same way everywhere means exactly one of two equal paths gets pruned.
+        */
+        static void findWitnesses(const Vec3i cell, const Vec3i target, const Via& via, double cost, int order,
+                                  std::uint32_t between, std::uint32_t visited, std::vector<std::uint32_t>& found) {
+            for (int x = -1; x <= 1; x++) {
+                for (int y = -1; y <= 1; y++) {
+                    for (int z = -1; z <= 1; z++) {
+                        Vec3i step(x, y, z);
+                        Vec3i next = cell + step;
+                        if ((x == 0 && y == 0 && z == 0) || std::abs(next[0]) > 1 || std::abs(next[1]) > 1 ||
+                            std::abs(next[2]) > 1 || (next[0] == 0 && next[1] == 0 && next[2] == 0)) {
+                            continue;
+                        }
+                        std::uint32_t bit = 1u << neighborNumber(next[0], next[1], next[2]);
+                        double nextCost = cost + distance(cell, next);
+                        int nextOrder = order*4 + moveSize(step);
+                        if ((visited & bit) || nextCost > via.cost + 1e-9) {
+                            continue;
+                        }
+                        if (next == target) {
+                            if (nextCost < via.cost - 1e-9 || nextOrder > via.order) {
+                                found.push_back(between);
+                            }
+                        } else {
+                            findWitnesses(next, target, via, nextCost, nextOrder, between | bit, visited | bit, found);
+                        }
+                    }
+                }
+            }
+        }
+
+        // drops witnesses that contain another witness, they are blocked whenever the smaller one is
+        static std::vector<std::uint32_t> minimal(const std::vector<std::uint32_t>& masks) {
+            std::vector<std::uint32_t> result;
+            for (unsigned int i = 0; i < masks.size(); ++i) {
+                bool keep = true;
+                for (unsigned int j = 0; j < masks.size() && keep; ++j) {
+                    if (masks[j] != masks[i] && (masks[j] & masks[i]) == masks[j]) {
+                        keep = false;
+                    }
+                }
+                if (keep && std::find(result.begin(), result.end(), masks[i]) == result.end()) {
+                    result.push_back(masks[i]);
+                }
+            }
+            std::sort(result.begin(), result.end()); // an empty witness, if any, comes first
+            return result;
+        }
+
+        Direction directions[Grid::NEIGHBOR_COUNT];
+    };
+
+    const JumpTables TABLES;
+
+    class Jumper {
+     public:
+        Jumper(const Grid& grid, int endIndex) : grid(grid), neighbors(grid.getNeighbors()), endIndex(endIndex) {}
+
+        static bool isSuccessor(const JumpRule& rule, std::uint32_t free) {
+            if (!(free & (1u << rule.neighbor))) {
+                return false;
+            }
+            if (rule.natural) {
+                return true;
+            }
+            for (unsigned int w = 0; w < rule.witnesses.size(); ++w) {
+                if ((rule.witnesses[w] & free) == rule.witnesses[w]) {
+                    return false; // an equally short path around the node is open
+                }
+            }
+            return true;
+        }
+
+        bool hasForced(int index, const Direction& direction) const {
+            std::uint32_t free = grid.getWalkableNeighbors(index);
+            if ((free & direction.witnessCells) == direction.witnessCells) {
+                return false; // the usual case in open space
+            }
+            for (unsigned int i = 0; i < direction.rules.size(); ++i) {
+                const JumpRule& rule = direction.rules[i];
+                if (!rule.natural && isSuccessor(rule, free)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // steps from index in direction dir until a jump point, returns its index or -1 at a wall
+        int jump(int index, int dir) const {
+            const Direction& direction = TABLES.directions[dir];
+            int delta = neighbors[dir].delta;
+            while (true) {
+                index += delta;
+                if (!grid.isWalkable(index)) {
+                    return -1; // also stops at the padding around the grid
+                }
+                if (index == endIndex || hasForced(index, direction)) {
+                    return index;
+                }
+                for (unsigned int i = 0; i < direction.subDirections.size(); ++i) {
+                    if (jump(index, direction.subDirections[i]) >= 0) {
+                        return index;
+                    }
+                }
+            }
+        }
+     private:
+        const Grid& grid;
+        const GridNeighbor* neighbors;
+        int endIndex;
+    };
+
+    int sign(int a) {
+        return (a > 0) - (a < 0);
+    }
+}
+
+Path jps(const Grid& grid, const Vec3i start, const Vec3i end, SearchArena& arena) {
+    if (grid.hasCosts()) {
+        return astar(grid, start, end, arena);
+    }
+    Path path;
+    int startIndex = grid.getIndex(start[0], start[1], start[2]);
+    int endIndex = grid.getIndex(end[0], end[1], end[2]);
+    if (startIndex < 0 || endIndex < 0 || !grid.isWalkable(startIndex) || !grid.isWalkable(endIndex)) {
+        return path;
+    }
+
+    Jumper jumper(grid, endIndex);
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    arena.begin(grid.getCellCount());
+    IndexedHeap<double>& open = arena.getOpen();
+    arena.visit(startIndex, 0.0, -1);
+    open.push(startIndex, distance(end, start));
+    while (!open.empty()) {
+        int currentIndex = open.pop();
+        if (currentIndex == endIndex) {
+            break;
+        }
+        arena.close(currentIndex);
+
+        Vec3i cell = grid.getCell(currentIndex);
+        double g = arena.getG(currentIndex);
+        auto relax = [&](int dir) {
+            int index = jumper.jump(currentIndex, dir);
+            if (index < 0 || arena.isClosed(index)) {
+                return;
+            }
+            Vec3i next = grid.getCell(index);
+            Vec3i span = next - cell;
+            int steps = std::max(std::abs(span[0]), std::max(std::abs(span[1]), std::abs(span[2])));
+            double newG = g + steps * neighbors[dir].cost;
+            if (arena.improves(index, newG)) {
+                arena.relax(index, newG, currentIndex, newG + distance(end, next));
+            }
+        };
+
+        int parentIndex = arena.getParent(currentIndex);
+        if (parentIndex < 0) {
+            for (int dir = 0; dir < Grid::NEIGHBOR_COUNT; ++dir) { // the start looks every way
+                relax(dir);
+            }
+        } else {
+            // otherwise the successors depend on the direction of arrival
+            Vec3i d = cell - grid.getCell(parentIndex);
+            const Direction& direction = TABLES.directions[neighborNumber(sign(d[0]), sign(d[1]), sign(d[2]))];
+            std::uint32_t free = grid.getWalkableNeighbors(currentIndex);
+            for (unsigned int i = 0; i < direction.rules.size(); ++i) {
+                if (Jumper::isSuccessor(direction.rules[i], free)) {
+                    relax(direction.rules[i].neighbor);
+                }
+            }
+        }
+    }
+
+    if (!arena.isVisited(endIndex)) {
+        return path;
+    }
+    path.found = true;
+    path.cost = arena.getG(endIndex);
+    // walk the jump points back to the start, filling in the straight runs between them
+    path.waypoints.push_back(end);
+    for (int index = endIndex; arena.getParent(index) >= 0; index = arena.getParent(index)) {
+        Vec3i from = grid.getCell(index);
+        Vec3i to = grid.getCell(arena.getParent(index));
+        Vec3i step(sign(to[0] - from[0]), sign(to[1] - from[1]), sign(to[2] - from[2]));
+        while (!(from == to)) {
+            from = from + step;
+            path.waypoints.push_back(from);
+        }
+    }
+    std::reverse(path.waypoints.begin(), path.waypoints.end());
+    return path;
+}
+
+Path jps(const Grid& grid, const Vec3i start, const Vec3i end) {
+    SearchArena arena;
+    return jps(grid, start, end, arena);
+}
@@ -0,0 +1,18 @@
+#ifndef JPS_HPP
+#define JPS_HPP
+
+#include "astar/astar.hpp"
+#include "astar/grid.hpp"
+#include "astar/searcharena.hpp"
+
+#include "math/vec.hpp"
+
+// jump point search over the 26-connected grid. it returns paths of the same cost as astar() but only
+// pushes jump points (cells with forced neighbors) onto the open set, so open regions are crossed
+// with a handful of expansions. the waypoints are expanded back out to every cell along the path.
+// jumping is only valid when every step into a cell costs its length, so grids with a cost layer
+// are searched with astar() instead
+Path jps(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end, SearchArena& arena);
+Path jps(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end);
+
+#endif
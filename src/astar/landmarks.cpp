@@ -0,0 +1,275 @@
+#include "astar/landmarks.hpp"
+
+#include <atomic>
+#include <limits>
+#include <thread>
+
+#include "astar/expand.hpp"
+#include "astar/searcharena.hpp"
+
+using namespace Math3D;
+
+namespace {
+    /*
+    Dijkstra over the whole grid from source, storing the cost from source to every cell in distances. A
+    reverse flood follows steps backwards and stores the cost from every cell to source instead.
+    */
+    void flood(const Grid& grid, int source, bool reverse, SearchArena& arena, std::vector<float>& distances) {
+        distances.assign(grid.getCellCount(), INF);
+        arena.begin(grid.getCellCount());
+        IndexedHeap<double>& open = arena.getOpen();
+        arena.visit(source, 0.0, -1);
+        open.push(source, 0.0);
+        while (!open.empty()) {
+            int current = open.pop();
+            arena.close(current);
+            distances[current] = arena.getG(current);
+            expandNeighbors(grid, arena, current, reverse, false, [](const Vec3i, int) { return 0.0; }, AnyCell(),
+                            IgnoreRelaxed());
+        }
+    }
+}
+
+Landmarks::Landmarks(Grid& grid) : grid(grid), ready(false), changes(0) {
+    grid.addListener(this);
+}
+
+Landmarks::~Landmarks() {
+    grid.removeListener(this);
+}
+
+void Landmarks::onCellChanged(int) {
+    std::lock_guard<std::mutex> lock(mutex);
+    changes++;
+    ready = false;
+    tables.reset();
+}
+
+void Landmarks::onGridReset() {
+    onCellChanged(-1);
+}
+
+void Landmarks::build(int landmarkCount, unsigned int threads) {
+    unsigned int changesBefore = changes;
+    std::shared_ptr<Tables> built(new Tables());
+    pickLandmarks(landmarkCount, built->landmarks);
+    int count = built->landmarks.size();
+    built->count = count;
+    if (count == 0) {
+        publish(nullptr, changesBefore);
+        return;
+    }
+
+    // one job per table column, the reverse floods are only needed when costs differ by direction
+    int cellCount = grid.getCellCount();
+    bool symmetric = !grid.hasCosts();
+    int jobs = symmetric ? count : 2 * count;
+    std::vector<std::vector<float> > columns(jobs);
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    threads = std::max(1u, std::min(threads, (unsigned int) jobs));
+    std::atomic<int> next(0);
+    auto work = [&]() {
+        SearchArena arena;
+        for (int job = next++; job < jobs; job = next++) {
+            flood(grid, built->landmarks[job % count], job >= count, arena, columns[job]);
+        }
+    };
+    std::vector<std::thread> helpers;
+    for (unsigned int i = 1; i < threads; ++i) {
+        helpers.push_back(std::thread(work));
+    }
+    work();
+    for (unsigned int i = 0; i < helpers.size(); ++i) {
+        helpers[i].join();
+    }
+
+    // interleaved so the distances of one cell to every landmark share a cache line
+    built->from.resize(cellCount * count);
+    if (!symmetric) {
+        built->toLandmark.resize(cellCount * count);
+    }
+    for (int index = 0; index < cellCount; ++index) {
+        for (int i = 0; i < count; ++i) {
+            built->from[index * count + i] = columns[i][index];
+            if (!symmetric) {
+                built->toLandmark[index * count + i] = columns[count + i][index];
+            }
+        }
+    }
+    built->setSlack();
+    publish(built, changesBefore);
+}
+
+void Landmarks::publish(const std::shared_ptr<const Tables>& built, unsigned int changesBefore) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (changes != changesBefore) {
+        return; // built from a grid that has changed since, the tables were already dropped
+    }
+    tables = built;
+    ready = tables != nullptr;
+}
+
+/*
+Spreads the landmarks out by straight line distance: the first is the walkable cell farthest from the
+center of the grid, each next one the walkable cell farthest from every landmark picked so far. Landmarks
+on the edges of the map give the tightest bounds for paths heading towards or away from them.
+*/
+void Landmarks::pickLandmarks(int landmarkCount, std::vector<int>& landmarks) const {
+    landmarks.clear();
+    Vec3i extents = grid.getExtents();
+    std::vector<int> cells;
+    std::vector<Vec3i> positions;
+    for (int x = -extents[0]; x <= extents[0] && grid.getCellCount() > 0; x++) {
+        for (int y = -extents[1]; y <= extents[1]; y++) {
+            for (int z = -extents[2]; z <= extents[2]; z++) {
+                int index = grid.getIndex(x, y, z);
+                if (grid.isWalkable(index)) {
+                    cells.push_back(index);
+                    positions.push_back(Vec3i(x, y, z));
+                }
+            }
+        }
+    }
+    // squared distance from each cell to its nearest landmark, the center stands in for the first one
+    std::vector<int> nearest(cells.size());
+    for (unsigned int i = 0; i < cells.size(); ++i) {
+        nearest[i] = positions[i].dot(positions[i]);
+    }
+    while ((int) landmarks.size() < landmarkCount) {
+        int farthest = -1;
+        for (unsigned int i = 0; i < cells.size(); ++i) {
+            if (nearest[i] > 0 && (farthest < 0 || nearest[i] > nearest[farthest])) {
+                farthest = i;
+            }
+        }
+        if (farthest < 0) {
+            break; // fewer walkable cells than landmarks
+        }
+        landmarks.push_back(cells[farthest]);
+        for (unsigned int i = 0; i < cells.size(); ++i) {
+            Vec3i d = positions[i] - positions[farthest];
+            nearest[i] = std::min(nearest[i], d.dot(d));
+        }
+    }
+}
+
+void Landmarks::Tables::setSlack() {
+    // a float is within 2^-24 of the double it was rounded from, and each bound takes the difference of two
+    float largest = 0.0f;
+    for (unsigned int i = 0; i < from.size(); ++i) {
+        if (from[i] < INF) {
+            largest = std::max(largest, from[i]);
+        }
+    }
+    for (unsigned int i = 0; i < toLandmark.size(); ++i) {
+        if (toLandmark[i] < INF) {
+            largest = std::max(largest, toLandmark[i]);
+        }
+    }
+    slack = largest * 1e-6;
+}
+
+bool Landmarks::isReady() const {
+    return ready;
+}
+
+std::shared_ptr<const Landmarks::Tables> Landmarks::getTables() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tables;
+}
+
+int Landmarks::getCount() const {
+    std::shared_ptr<const Tables> current = getTables();
+    return current != nullptr ? current->count : 0;
+}
+
+Vec3i Landmarks::getLandmark(int i) const {
+    return grid.getCell(getTables()->landmarks[i]);
+}
+
+void Landmarks::save(std::ostream& outs) const {
+    std::shared_ptr<const Tables> current = getTables();
+    int count = current != nullptr ? current->count : 0;
+    Vec3i extents = grid.getExtents();
+    outs << count << " " << (count > 0 && !current->toLandmark.empty()) << std::endl;
+    outs << extents[0] << " " << extents[1] << " " << extents[2] << std::endl;
+    if (count == 0) {
+        return;
+    }
+    const std::vector<float>& from = current->from;
+    const std::vector<float>& toLandmark = current->toLandmark;
+    for (int i = 0; i < count; ++i) {
+        Vec3i cell = grid.getCell(current->landmarks[i]);
+        outs << cell[0] << " " << cell[1] << " " << cell[2] << std::endl;
+    }
+
+    // one line per cell, its distances from each landmark and then to each, -1 when unreachable
+    std::streamsize precision = outs.precision(std::numeric_limits<float>::max_digits10);
+    for (int x = -extents[0]; x <= extents[0]; x++) {
+        for (int y = -extents[1]; y <= extents[1]; y++) {
+            for (int z = -extents[2]; z <= extents[2]; z++) {
+                int index = grid.getIndex(x, y, z);
+                for (int i = 0; i < count; ++i) {
+                    outs << (from[index * count + i] < INF ? from[index * count + i] : -1.0f) << " ";
+                }
+                for (int i = 0; i < count && !toLandmark.empty(); ++i) {
+                    outs << (toLandmark[index * count + i] < INF ? toLandmark[index * count + i] : -1.0f) << " ";
+                }
+                outs << std::endl;
+            }
+        }
+    }
+    outs.precision(precision);
+}
+
+bool Landmarks::load(std::istream& ins) {
+    unsigned int changesBefore = changes;
+    std::shared_ptr<Tables> loaded(new Tables());
+    int count, asymmetric;
+    Vec3i extents;
+    ins >> count >> asymmetric >> extents[0] >> extents[1] >> extents[2];
+    int cellCount = grid.getCellCount();
+    if (ins.fail() || !(extents == grid.getExtents()) || cellCount == 0 || count < 0 || count > cellCount) {
+        publish(nullptr, changesBefore);
+        return false;
+    }
+    loaded->count = count;
+    loaded->landmarks.resize(count);
+    for (int i = 0; i < count; ++i) {
+        int x, y, z;
+        ins >> x >> y >> z;
+        loaded->landmarks[i] = grid.getIndex(x, y, z);
+        if (ins.fail() || loaded->landmarks[i] < 0) {
+            publish(nullptr, changesBefore);
+            return false;
+        }
+    }
+
+    loaded->from.assign(cellCount * count, INF);
+    loaded->toLandmark.assign(asymmetric ? cellCount * count : 0, INF);
+    float distance;
+    for (int x = -extents[0]; x <= extents[0]; x++) {
+        for (int y = -extents[1]; y <= extents[1]; y++) {
+            for (int z = -extents[2]; z <= extents[2]; z++) {
+                int index = grid.getIndex(x, y, z);
+                for (int i = 0; i < count; ++i) {
+                    ins >> distance;
+                    loaded->from[index * count + i] = distance < 0.0f ? INF : distance;
+                }
+                for (int i = 0; i < count && asymmetric; ++i) {
+                    ins >> distance;
+                    loaded->toLandmark[index * count + i] = distance < 0.0f ? INF : distance;
+                }
+            }
+        }
+    }
+    if (ins.fail()) {
+        publish(nullptr, changesBefore);
+        return false;
+    }
+    loaded->setSlack();
+    publish(count > 0 ? loaded : nullptr, changesBefore);
+    return true;
+}
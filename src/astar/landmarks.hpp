@@ -0,0 +1,101 @@
+#ifndef LANDMARKS_HPP
+#define LANDMARKS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "astar/grid.hpp"
+
+#include "math/vec.hpp"
+
+// distance tables for the ALT heuristic (A*, landmarks, triangle inequality). a few landmark cells are picked
+// far apart and the cost of the shortest path from each landmark to every cell, and from every cell back to
+// each landmark, is flooded out once. for any cell v and target t, d(L, t) - d(L, v) and d(v, L) - d(t, L)
+// are then lower bounds on d(v, t), which around walls are far tighter than the straight line distance.
+// the tables go stale as soon as the grid changes (stale bounds could overestimate), so they listen to the
+// grid and stop being used until built or loaded again
+class Landmarks : public GridListener {
+ public:
+    // one set of distance tables. they never change once published, a search holds on to the ones it started
+    // with so a build running meanwhile can swap in new tables without pulling them out from under it
+    class Tables {
+     public:
+        int getCount() const { return count; }
+
+        // lower bound on the cost of the shortest path from the cell at index to the cell at target, infinite
+        // when the tables prove there is none
+        double getLowerBound(int index, int target) const {
+            const float* fromCell = &from[index * count];
+            const float* fromTarget = &from[target * count];
+            const float* toCell = &to()[index * count];
+            const float* toTarget = &to()[target * count];
+            double bound = 0.0;
+            for (int i = 0; i < count; ++i) {
+                if (fromCell[i] < INF) {
+                    if (fromTarget[i] == INF) {
+                        return INF; // the landmark reaches the cell but not the target, so neither does the cell
+                    }
+                    bound = std::max(bound, (double) fromTarget[i] - fromCell[i]);
+                }
+                if (toCell[i] < INF && toTarget[i] < INF) {
+                    bound = std::max(bound, (double) toCell[i] - toTarget[i]);
+                }
+            }
+            return bound - slack;
+        }
+     private:
+        friend class Landmarks;
+
+        int count;
+        std::vector<int> landmarks; // cell indices
+        // d(landmark i, cell) at cell * count + i and d(cell, landmark i) likewise, infinite when unreachable.
+        // without a cost layer every step costs the same both ways, so the two are equal and only from is kept
+        std::vector<float> from, toLandmark;
+        double slack; // covers the rounding of the distances to float, so bounds never overestimate
+
+        const std::vector<float>& to() const {
+            return toLandmark.empty() ? from : toLandmark;
+        }
+        void setSlack();
+    };
+
+    Landmarks(Grid& grid);
+    ~Landmarks();
+    Landmarks(const Landmarks&) = delete;
+    Landmarks& operator=(const Landmarks&) = delete;
+
+    void onCellChanged(int index) override;
+    void onGridReset() override;
+
+    // picks count landmarks and floods them on threads threads including the caller, 0 uses every core. the
+    // tables are built aside and swapped in at the end, so it can run on another thread while searches use
+    // the old ones, but the grid must not change until it returns. a change during the build is noticed and
+    // the new tables are thrown away
+    void build(int landmarkCount, unsigned int threads = 0);
+    // true once built or loaded for the grid as it is now
+    bool isReady() const;
+    // the current tables, nullptr when not ready
+    std::shared_ptr<const Tables> getTables() const;
+    int getCount() const;
+    Math3D::Vec3i getLandmark(int i) const;
+
+    // text, after the grid the tables were built for. load returns false and leaves the tables unusable when
+    // they were saved for a grid of a different size, or the count or a landmark doesn't fit the grid
+    void save(std::ostream& outs) const;
+    bool load(std::istream& ins);
+ private:
+    Grid& grid;
+    mutable std::mutex mutex; // guards tables
+    std::shared_ptr<const Tables> tables;
+    std::atomic<bool> ready;
+    std::atomic<unsigned int> changes; // counts grid changes, so a build can tell the grid moved under it
+
+    void publish(const std::shared_ptr<const Tables>& built, unsigned int changesBefore);
+    void pickLandmarks(int landmarkCount, std::vector<int>& landmarks) const;
+};
+
+#endif
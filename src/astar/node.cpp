@@ -2,24 +2,10 @@
 
 using namespace Math3D;
 
-Node::Node() {
-    parent = nullptr;
-    h = 0.0;
-    g = 0.0;
-}
+Node::Node() {}
 
 Node::Node(const Vector4 pos) {
-    parent = nullptr;
-    position = pos;
-    h = 0.0;
-    g = 0.0;
-}
-
-Node::Node(const Vector4 pos, Node* par, const Node* end) {
-    parent = par;
     position = pos;
-    h = end->getDistanceTo(position);
-    g = par->getPathDistance(position);
 }
 
 void Node::setPosition(const Vector4 pos) {
@@ -33,36 +19,3 @@ Vector4 Node::getPosition() const {
 double Node::getDistanceTo(const Vector4 pos) const {
     return (position - pos).magnitude();
 }
-
-double Node::getPathDistance(const Vector4 pos) const {
-    return g + (position - pos).magnitude();
-}
-
-void Node::updateH(const Node* end) {
-    h = end->getDistanceTo(position);
-}
-
-void Node::updateParent(Node* par) {
-    if (parent == nullptr) {
-        parent = par;
-        g = par->getPathDistance(position);
-    } else {
-        double newG = par->getPathDistance(position);
-        if (newG < g) {
-            parent = par;
-            g = newG;
-        }
-    }
-}
-
-Node* Node::getParent() const {
-    return parent;
-}
-
-double Node::getCost() const {
-    return (h + g);
-}
-
-bool Node::operator<(const Node& other) const {
-    return (g + h) < (other.g + other.h);
-}
@@ -0,0 +1,141 @@
+#include "astar/pathcache.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+using std::size_t;
+using namespace Math3D;
+
+PathCache::PathCache(Grid& grid, size_t capacity, unsigned int shards) :
+    grid(grid), shardCapacity(capacity / std::max(1u, shards)), shards(std::max(1u, shards)), hits(0), misses(0) {
+    for (unsigned int i = 0; i < this->shards.size(); ++i) {
+        this->shards[i].cells = 0;
+    }
+    grid.addListener(this);
+}
+
+PathCache::~PathCache() {
+    grid.removeListener(this);
+}
+
+std::uint64_t PathCache::getKey(const Vec3i start, const Vec3i end, bool& inside) const {
+    int startIndex = grid.getIndex(start[0], start[1], start[2]);
+    int endIndex = grid.getIndex(end[0], end[1], end[2]);
+    inside = startIndex >= 0 && endIndex >= 0;
+    return (std::uint64_t) startIndex << 32 | (std::uint32_t) endIndex;
+}
+
+PathCache::Shard& PathCache::getShard(std::uint64_t key) {
+    // mixed so that queries from one start to nearby ends don't all land in the same shard
+    key *= 0x9e3779b97f4a7c15ull;
+    return shards[(key >> 32) % shards.size()];
+}
+
+bool PathCache::find(const Vec3i start, const Vec3i end, Path& path) {
+    bool inside;
+    std::uint64_t key = getKey(start, end, inside);
+    if (inside) {
+        Shard& shard = getShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.byKey.find(key);
+        if (found != shard.byKey.end()) {
+            shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+            path = found->second->path;
+            hits++;
+            return true;
+        }
+    }
+    misses++;
+    return false;
+}
+
+void PathCache::insert(const Vec3i start, const Vec3i end, const Path& path) {
+    bool inside;
+    std::uint64_t key = getKey(start, end, inside);
+    if (!inside || !path.found || path.waypoints.size() > shardCapacity) {
+        return;
+    }
+    Shard& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.byKey.find(key);
+    if (found != shard.byKey.end()) {
+        remove(shard, found->second);
+    }
+    while (shard.cells + path.waypoints.size() > shardCapacity) {
+        remove(shard, std::prev(shard.entries.end()));
+    }
+
+    shard.entries.push_front(Entry());
+    auto entry = shard.entries.begin();
+    entry->key = key;
+    entry->path = path;
+    entry->cells.reserve(path.waypoints.size());
+    for (size_t i = 0; i < path.waypoints.size(); ++i) {
+        const Vec3i& cell = path.waypoints[i];
+        int index = grid.getIndex(cell[0], cell[1], cell[2]);
+        entry->cells.push_back(index);
+        shard.byCell[index].push_back(entry);
+    }
+    shard.byKey[key] = entry;
+    shard.cells += path.waypoints.size();
+}
+
+void PathCache::remove(Shard& shard, std::list<Entry>::iterator entry) {
+    for (size_t i = 0; i < entry->cells.size(); ++i) {
+        auto crossing = shard.byCell.find(entry->cells[i]);
+        std::vector<std::list<Entry>::iterator>& crossed = crossing->second;
+        auto position = std::find(crossed.begin(), crossed.end(), entry);
+        *position = crossed.back();
+        crossed.pop_back();
+        if (crossed.empty()) {
+            shard.byCell.erase(crossing);
+        }
+    }
+    shard.cells -= entry->path.waypoints.size();
+    shard.byKey.erase(entry->key);
+    shard.entries.erase(entry);
+}
+
+void PathCache::onCellChanged(int index) {
+    for (size_t i = 0; i < shards.size(); ++i) {
+        Shard& shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto crossing = shard.byCell.find(index);
+        while (crossing != shard.byCell.end()) {
+            remove(shard, crossing->second.back()); // erases crossing once the last entry is gone
+            crossing = shard.byCell.find(index);
+        }
+    }
+}
+
+void PathCache::onGridReset() {
+    clear();
+}
+
+void PathCache::clear() {
+    for (size_t i = 0; i < shards.size(); ++i) {
+        Shard& shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.byKey.clear();
+        shard.byCell.clear();
+        shard.cells = 0;
+    }
+}
+
+size_t PathCache::getHits() const {
+    return hits;
+}
+
+size_t PathCache::getMisses() const {
+    return misses;
+}
+
+size_t PathCache::getSize() const {
+    size_t size = 0;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        size += shards[i].byKey.size();
+    }
+    return size;
+}
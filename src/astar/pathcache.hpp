@@ -0,0 +1,66 @@
+#ifndef PATHCACHE_HPP
+#define PATHCACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "astar/astar.hpp"
+#include "astar/grid.hpp"
+
+#include "math/vec.hpp"
+
+// a cache of found paths keyed on their start and end cells, safe to use from several threads. the least
+// recently used paths are dropped once the waypoints kept pass the capacity. every cached cell points back
+// at the paths crossing it, so a path is dropped as soon as a cell on it changes and no other path is.
+// a kept path can still be walked, but it is no longer the shortest when a change elsewhere opens a shorter
+// way. paths that were not found aren't cached, since any change anywhere could open one up
+class PathCache : public GridListener {
+ public:
+    // capacity is the most waypoints kept over every path, spread across shards separately locked parts
+    PathCache(Grid& grid, std::size_t capacity = 1 << 20, unsigned int shards = 16);
+    ~PathCache();
+    PathCache(const PathCache&) = delete;
+    PathCache& operator=(const PathCache&) = delete;
+
+    void onCellChanged(int index) override;
+    void onGridReset() override;
+
+    // copies the cached path into path and returns true if there is one
+    bool find(const Math3D::Vec3i start, const Math3D::Vec3i end, Path& path);
+    void insert(const Math3D::Vec3i start, const Math3D::Vec3i end, const Path& path);
+    void clear();
+
+    std::size_t getHits() const;
+    std::size_t getMisses() const;
+    std::size_t getSize() const;
+ private:
+    struct Entry {
+        std::uint64_t key;
+        Path path;
+        std::vector<int> cells;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> entries; // most recently used first
+        std::unordered_map<std::uint64_t, std::list<Entry>::iterator> byKey;
+        std::unordered_map<int, std::vector<std::list<Entry>::iterator> > byCell; // the entries crossing each cell
+        std::size_t cells; // waypoints kept
+    };
+
+    Grid& grid;
+    std::size_t shardCapacity;
+    std::vector<Shard> shards;
+    std::atomic<std::size_t> hits, misses;
+
+    std::uint64_t getKey(const Math3D::Vec3i start, const Math3D::Vec3i end, bool& inside) const;
+    Shard& getShard(std::uint64_t key);
+    void remove(Shard& shard, std::list<Entry>::iterator entry);
+};
+
+#endif
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#include "mains/mains.hpp"
+
+#include "astar/astar.hpp"
+#include "astar/grid.hpp"
+
+#include "render_base/exception.hpp"
+
+using std::size_t;
+using namespace Math3D;
+using namespace Render3D;
+
+static const float GRID_SIZE = 2.0;
+
+void pathfind() {
+    /*Grid grid;
+    std::ifstream ifs("res/astargrid.txt");
+    if (ifs.fail()) {
+        std::cout << "Failed to open input file" << std::endl;
+        exit(-1);
+    }
+    grid.load(ifs);
+    ifs.close();*/
+
+    Grid grid(20, 10, 20);
+    for (int x = -20; x <= 20; x++) {
+        for (int y = -10; y <= 10; y++) {
+            for (int z = -20; z <= 20; z++) {
+                if (y == 0 || (x <= 5 && x >= -5 && y > 0 && y <= 10 && z == 0)) {
+                    grid.setWalkable(x, y, z, false);
+                } else {
+                    grid.setWalkable(x, y, z, true);
+                }
+            }
+        }
+    }
+
+    std::ofstream ofs("res/astargrid.txt");
+    if (ofs.fail()) {
+        std::cout << "Failed to open output file" << std::endl;
+        exit(-1);
+    }
+    grid.save(ofs);
+    ofs.close();
+
+    Window window(WIDTH, HEIGHT, "A* Pathfinding");
+
+    Context3D* context = window.getContext();
+
+    Shader defaultShader = Shader::defaultPerspective();
+    try {
+        context->addShader(&defaultShader);
+    } catch (Exception& ex) { // catch shader compilation issues
+        std::cout << ex << std::endl;
+        exit(-1);
+    }
+
+    Camera* cam = context->getCamera();
+
+    std::vector<Cuboid*> walls;
+    for (int x = -20; x <= 20; x++) {
+        for (int y = -10; y <= 10; y++) {
+            for (int z = -20; z <= 20; z++) {
+                if (!grid.isWalkable(x, y, z)) {
+                    Cuboid* cube = new Cuboid();
+                    cube->setSize(Vector4(GRID_SIZE, GRID_SIZE, GRID_SIZE));
+                    cube->setCFrame(Matrix4x4(x * GRID_SIZE, y * GRID_SIZE, z * GRID_SIZE));
+                    cube->setColor(Color(0.75, 0.75, 0.75));
+                    cube->setShader(&defaultShader);
+                    context->addObject(cube);
+                    walls.push_back(cube);
+                }
+            }
+        }
+    }
+
+    std::vector<Sphere*> paths;
+    Path path = astar(grid, Vec3i(0, 2, 5), Vec3i(0, 2, -5));
+    for (size_t i = 0; i < path.waypoints.size(); ++i) {
+        Vec3i cell = path.waypoints[i];
+        std::cout << cell << std::endl;
+        Sphere* sphere = new Sphere();
+        sphere->setSize(Vector4(GRID_SIZE, GRID_SIZE, GRID_SIZE));
+        sphere->setCFrame(Matrix4x4(cell[0] * GRID_SIZE, cell[1] * GRID_SIZE, cell[2] * GRID_SIZE));
+        sphere->setColor(Color(0, 0.8, 0));
+        sphere->setShader(&defaultShader);
+        context->addObject(sphere);
+        paths.push_back(sphere);
+    }
+
+    float cX, cY;
+    cX = cY = 0;
+    window.setMouseDownCallback([&window](MOUSE_BUTTON button, int x, int y) {
+        if (button == MOUSE_BUTTON::RIGHT) { // right mouse button
+            window.setMouseLockEnabled(true);
+        }
+    });
+    window.setMouseUpCallback([&window](MOUSE_BUTTON button, int x, int y) {
+        if (button == MOUSE_BUTTON::RIGHT) { // right mouse button
+            window.setMouseLockEnabled(false);
+        }
+    });
+    window.setMouseMoveCallback([&window, &cX, &cY](int x, int y, int dx, int dy) {
+        if (window.isMouseDown(MOUSE_BUTTON::RIGHT)) {
+            cX -= dx * MOUSE_SENS;
+            cY = std::max(std::min(cY - dy * MOUSE_SENS, 90.0f), -90.0f);
+        }
+    });
+    window.setKeyUpCallback([&window](KEYCODE key) {
+        if (key == KEYCODE::F11) {
+            window.toggleFullscreen();
+        }
+    });
+
+    window.setVSyncEnabled(false);
+
+    while (window.isActive()) {
+        window.updateViewport();
+        window.clear();
+
+        updateCamera(cam, &window, cX, cY);
+
+        context->render();
+
+        window.update();
+        window.pollEvents();
+    }
+
+    window.close(); // window must be closed to clean up resources it uses
+    /* WARNING: closing a window requires the objects it currently uses to still exist,
+                so do NOT delete an object or let it go out of scope until it has been removed
+                from all contexts or all windows that use it have been closed. in the future I will
+                likely implement the Context3D to use shared_ptrs instead of raw c pointers */
+
+    for (int i = 0; i < walls.size(); ++i) {
+        delete walls[i];
+    }
+    for (int i = 0; i < paths.size(); ++i) {
+        delete paths[i];
+    }
+}
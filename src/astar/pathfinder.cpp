@@ -0,0 +1,149 @@
+#include "astar/pathfinder.hpp"
+
+using std::size_t;
+
+PathFinder::PathFinder(const Grid& grid, unsigned int threads) : grid(grid) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+    search = SEARCH::ASTAR;
+    components = nullptr;
+    cache = nullptr;
+    batch = 0;
+    busy = 0;
+    stopping = false;
+    queries = nullptr;
+    paths = nullptr;
+    count = 0;
+    next = 0;
+
+    arenas.resize(threads);
+    workers.reserve(threads - 1);
+    for (unsigned int i = 0; i < threads - 1; ++i) {
+        workers.push_back(std::thread(&PathFinder::run, this, i));
+    }
+}
+
+PathFinder::~PathFinder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (unsigned int i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+}
+
+unsigned int PathFinder::getThreadCount() const {
+    return arenas.size();
+}
+
+void PathFinder::setSearch(SEARCH mode) {
+    std::lock_guard<std::mutex> batchLock(batchMutex);
+    search = mode;
+}
+
+SEARCH PathFinder::getSearch() const {
+    return search;
+}
+
+void PathFinder::setComponents(Components* components) {
+    std::lock_guard<std::mutex> batchLock(batchMutex);
+    this->components = components;
+}
+
+void PathFinder::setCache(PathCache* cache) {
+    std::lock_guard<std::mutex> batchLock(batchMutex);
+    this->cache = cache;
+}
+
+void PathFinder::findPaths(const PathQuery* queries, size_t count, Path* paths) {
+    std::lock_guard<std::mutex> batchLock(batchMutex);
+    if (count == 0) {
+        return;
+    }
+    if (components != nullptr) {
+        components->update();
+    }
+    if (workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            paths[i] = find(queries[i], arenas.back());
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->queries = queries;
+        this->paths = paths;
+        this->count = count;
+        next = 0;
+        busy = workers.size();
+        batch++;
+    }
+    wake.notify_all();
+
+    work(arenas.back()); // the calling thread takes queries too
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() { return busy == 0; });
+}
+
+std::vector<Path> PathFinder::findPaths(const std::vector<PathQuery>& queries) {
+    std::vector<Path> paths(queries.size());
+    findPaths(queries.data(), queries.size(), paths.data());
+    return paths;
+}
+
+Path PathFinder::find(const PathQuery& query, SearchArena& arena) const {
+    if (components != nullptr && !components->isConnected(query.start, query.end)) {
+        return Path();
+    }
+    Path path;
+    if (cache != nullptr && cache->find(query.start, query.end, path)) {
+        return path;
+    }
+    if (search == SEARCH::JPS) {
+        path = jps(grid, query.start, query.end, arena);
+    } else {
+        path = astar(grid, query.start, query.end, arena);
+    }
+    if (cache != nullptr) {
+        cache->insert(query.start, query.end, path);
+    }
+    return path;
+}
+
+void PathFinder::work(SearchArena& arena) {
+    // queries vary wildly in cost, so they are handed out one at a time rather than in fixed chunks
+    size_t i;
+    while ((i = next.fetch_add(1)) < count) {
+        paths[i] = find(queries[i], arena);
+    }
+}
+
+void PathFinder::run(unsigned int worker) {
+    unsigned int seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen]() { return stopping || batch != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = batch;
+        }
+
+        work(arenas[worker]);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy--;
+        }
+        finished.notify_one();
+    }
+}
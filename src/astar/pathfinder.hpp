@@ -0,0 +1,79 @@
+#ifndef PATHFINDER_HPP
+#define PATHFINDER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "astar/astar.hpp"
+#include "astar/components.hpp"
+#include "astar/grid.hpp"
+#include "astar/jps.hpp"
+#include "astar/pathcache.hpp"
+#include "astar/searcharena.hpp"
+
+#include "math/vec.hpp"
+
+enum class SEARCH {ASTAR, JPS};
+
+struct PathQuery {
+    Math3D::Vec3i start;
+    Math3D::Vec3i end;
+};
+
+// runs batches of path queries on a grid across a pool of worker threads that lives as long as the
+// PathFinder, each thread keeps its own SearchArena so nothing is allocated per query once warmed up.
+// the grid must not be modified while findPaths is running
+class PathFinder {
+ public:
+    // threads is the total number of threads used including the caller, 0 uses every core
+    PathFinder(const Grid& grid, unsigned int threads = 0);
+    ~PathFinder();
+    PathFinder(const PathFinder&) = delete;
+    PathFinder& operator=(const PathFinder&) = delete;
+
+    // fills paths[i] with the result of queries[i]
+    void findPaths(const PathQuery* queries, std::size_t count, Path* paths);
+    std::vector<Path> findPaths(const std::vector<PathQuery>& queries);
+    unsigned int getThreadCount() const;
+    // JPS gives the same path costs as ASTAR with far fewer expansions, the default is ASTAR
+    void setSearch(SEARCH mode);
+    SEARCH getSearch() const;
+    // queries between cells in different components are answered without searching, the components are
+    // brought up to date at the start of each batch. nullptr (the default) searches every query
+    void setComponents(Components* components);
+    // found paths are looked up in and added to the cache, nullptr (the default) searches every query.
+    // a cached path is dropped when a cell on it changes, so it can always be walked, but a change elsewhere
+    // may open a shorter way that it doesn't take. the paths then cost more than those of the search until
+    // the cache is cleared
+    void setCache(PathCache* cache);
+ private:
+    const Grid& grid;
+    std::vector<std::thread> workers;
+    std::vector<SearchArena> arenas; // one per worker, the last one belongs to the calling thread
+    SEARCH search;
+    Components* components;
+    PathCache* cache;
+
+    std::mutex batchMutex; // only one batch runs at a time
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    unsigned int batch; // incremented to start a batch
+    unsigned int busy; // workers still running the current batch
+    bool stopping;
+
+    const PathQuery* queries;
+    Path* paths;
+    std::size_t count;
+    std::atomic<std::size_t> next;
+
+    Path find(const PathQuery& query, SearchArena& arena) const;
+    void work(SearchArena& arena);
+    void run(unsigned int worker);
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "astar/pathsearch.hpp"
+
+#include <algorithm>
+
+#include "astar/deadline.hpp"
+#include "astar/expand.hpp"
+
+using namespace Math3D;
+
+namespace {
+    struct Euclidean {
+        Vec3i end;
+        explicit Euclidean(const Vec3i end) : end(end) {}
+        double operator()(const Vec3i cell, int) const {
+            return distance(cell, end);
+        }
+    };
+}
+
+PathSearch::PathSearch(const Grid& grid, const Vec3i start, const Vec3i end, SearchArena& arena) :
+    grid(grid), start(start), end(end), arena(&arena) {
+    restart();
+}
+
+void PathSearch::restart() {
+    path = Path();
+    finished = false;
+    expansions = 0;
+    closest = distance(start, end);
+    startIndex = grid.getIndex(start[0], start[1], start[2]);
+    endIndex = grid.getIndex(end[0], end[1], end[2]);
+    if (startIndex < 0 || endIndex < 0 || !grid.isWalkable(startIndex) || !grid.isWalkable(endIndex)) {
+        finished = true;
+        return;
+    }
+    arena->begin(grid.getCellCount());
+    arena->visit(startIndex, 0.0, -1);
+    arena->getOpen().push(startIndex, distance(start, end));
+}
+
+bool PathSearch::step(int maxExpansions) {
+    for (int i = 0; i < maxExpansions && !finished; ++i) {
+        expand();
+    }
+    return finished;
+}
+
+bool PathSearch::step(std::chrono::microseconds budget) {
+    Deadline deadline(budget);
+    while (!finished && !deadline.passed()) {
+        expand();
+    }
+    return finished;
+}
+
+// one iteration of the loop in astar(), with the straight line heuristic
+void PathSearch::expand() {
+    IndexedHeap<double>& open = arena->getOpen();
+    if (open.empty()) {
+        finished = true;
+        return;
+    }
+    int currentIndex = open.pop();
+    if (currentIndex == endIndex) {
+        finish();
+        return;
+    }
+    arena->close(currentIndex);
+    expansions++;
+
+    closest = std::min(closest, distance(grid.getCell(currentIndex), end));
+    expandNeighbors(grid, *arena, currentIndex, Euclidean(end));
+}
+
+void PathSearch::finish() {
+    finished = true;
+    closest = 0.0;
+    path.found = true;
+    path.cost = arena->getG(endIndex);
+    for (int index = endIndex; index >= 0; index = arena->getParent(index)) {
+        path.waypoints.push_back(grid.getCell(index));
+    }
+    std::reverse(path.waypoints.begin(), path.waypoints.end());
+}
+
+bool PathSearch::isFinished() const {
+    return finished;
+}
+
+int PathSearch::getExpansions() const {
+    return expansions;
+}
+
+double PathSearch::getProgress() const {
+    if (finished) {
+        return 1.0;
+    }
+    double total = distance(start, end);
+    return total > 0.0 ? 1.0 - closest / total : 0.0;
+}
+
+bool PathSearch::touches(int index) const {
+    if (finished || startIndex < 0) {
+        return false;
+    }
+    if (arena->isVisited(index)) {
+        return true;
+    }
+    const GridNeighbor* neighbors = grid.getNeighbors();
+    for (int i = 0; i < Grid::NEIGHBOR_COUNT; ++i) {
+        if (arena->isVisited(index + neighbors[i].delta)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const Path& PathSearch::getPath() const {
+    return path;
+}
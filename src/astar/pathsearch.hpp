@@ -0,0 +1,49 @@
+#ifndef PATHSEARCH_HPP
+#define PATHSEARCH_HPP
+
+#include <chrono>
+
+#include "astar/astar.hpp"
+#include "astar/grid.hpp"
+#include "astar/searcharena.hpp"
+
+#include "math/vec.hpp"
+
+// the search of astar() cut into steps, so a long search can be spread over several frames. it keeps its
+// state in the arena between steps, so the arena belongs to it until it finishes. the grid may change
+// between steps only if the search is restarted when a cell it touches changes (see touches)
+class PathSearch {
+ public:
+    PathSearch(const Grid& grid, const Math3D::Vec3i start, const Math3D::Vec3i end, SearchArena& arena);
+
+    // throws away the work done so far and starts again
+    void restart();
+    // expands at most maxExpansions cells, returns true once finished
+    bool step(int maxExpansions);
+    // expands cells until finished or the time is up, returns true once finished
+    bool step(std::chrono::microseconds budget);
+
+    bool isFinished() const;
+    int getExpansions() const;
+    // how far towards the end the search has got, from 0 to 1, by the straight line distance of the closest
+    // cell expanded
+    double getProgress() const;
+    // true if a change to the cell could change the result, when it or one of its neighbors has been reached
+    bool touches(int index) const;
+    // the result, once finished
+    const Path& getPath() const;
+ private:
+    const Grid& grid;
+    Math3D::Vec3i start, end;
+    int startIndex, endIndex;
+    SearchArena* arena;
+    Path path;
+    bool finished;
+    int expansions;
+    double closest; // straight line distance to end of the closest cell expanded
+
+    void expand();
+    void finish();
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef SEARCHARENA_HPP
+#define SEARCHARENA_HPP
+
+#include <vector>
+
+#include "astar/indexedheap.hpp"
+
+/*
+Per-query search state (g, parent, open and closed membership) for every grid cell, kept outside
+the Grid so the grid stays read-only during a search and several searches can run at once, each
+with its own arena. Cells are stamped with the search generation, so starting a new search is O(1)
+and the storage is reused from query to query instead of being allocated and cleared each time.
+*/
+class SearchArena {
+ public:
+    SearchArena() : generation(0) {}
+
+    /*
+    Starts a new search over a grid with the given number of cells.
+    */
+    void begin(int cellCount) {
+        if ((int) cells.size() != cellCount) {
+            cells.assign(cellCount, Cell());
+            open.reset(cellCount);
+            generation = 0;
+        } else {
+            open.clear();
+        }
+        generation++;
+        if (generation == 0) { // stamps wrapped around, old stamps could look current
+            cells.assign(cellCount, Cell());
+            generation = 1;
+        }
+    }
+    /*
+    Returns true if the cell has been reached by the current search.
+    */
+    bool isVisited(int index) const { return cells[index].visited == generation; }
+    bool isClosed(int index) const { return cells[index].closed == generation; }
+
+    /*
+    Records a path to the cell of cost g through parent (-1 for the start).
+    */
+    void visit(int index, double g, int parent) {
+        Cell& cell = cells[index];
+        cell.visited = generation;
+        cell.g = g;
+        cell.parent = parent;
+    }
+    void close(int index) { cells[index].closed = generation; }
+    /*
+    Returns true if g is cheaper than the best path to the cell found so far.
+    */
+    bool improves(int index, double g) const { return !isVisited(index) || g < cells[index].g; }
+    /*
+    Offers the cell a path of cost g through parent. When it is cheaper than the best so far it is recorded
+    and the cell is queued on the open set with priority f, or moved up if already there, and true is
+    returned. A closed cell is reopened, searches that never reopen cells must skip closed ones first.
+    */
+    bool relax(int index, double g, int parent, double f) {
+        if (!improves(index, g)) {
+            return false;
+        }
+        visit(index, g, parent);
+        if (open.contains(index)) {
+            open.decrease(index, f);
+        } else {
+            open.push(index, f);
+        }
+        return true;
+    }
+
+    double getG(int index) const { return cells[index].g; }
+    int getParent(int index) const { return cells[index].parent; }
+
+    IndexedHeap<double>& getOpen() { return open; }
+ private:
+    struct Cell {
+        Cell() : g(0.0), parent(-1), visited(0), closed(0) {}
+        double g;
+        int parent;
+        unsigned int visited;
+        unsigned int closed;
+    };
+
+    std::vector<Cell> cells;
+    IndexedHeap<double> open;
+    unsigned int generation;
+};
+
+#endif
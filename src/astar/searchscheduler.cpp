@@ -0,0 +1,108 @@
+#include "astar/searchscheduler.hpp"
+
+#include <algorithm>
+
+using namespace Math3D;
+
+SearchScheduler::SearchScheduler(Grid& grid, int slice) : grid(grid), slice(slice), nextTicket(0) {
+    grid.addListener(this);
+}
+
+SearchScheduler::~SearchScheduler() {
+    grid.removeListener(this);
+}
+
+void SearchScheduler::onCellChanged(int index) {
+    for (unsigned int i = 0; i < pending.size(); ++i) {
+        PathSearch& search = *queries[pending[i]].search;
+        if (search.touches(index)) {
+            search.restart();
+        }
+    }
+}
+
+void SearchScheduler::onGridReset() {
+    for (unsigned int i = 0; i < pending.size(); ++i) {
+        queries[pending[i]].search->restart();
+    }
+}
+
+int SearchScheduler::submit(const Vec3i start, const Vec3i end) {
+    Query query;
+    if (freeArenas.empty()) {
+        arenas.push_back(std::unique_ptr<SearchArena>(new SearchArena()));
+        freeArenas.push_back(arenas.back().get());
+    }
+    query.arena = freeArenas.back();
+    freeArenas.pop_back();
+    query.search.reset(new PathSearch(grid, start, end, *query.arena));
+
+    int ticket = nextTicket++;
+    if (query.search->isFinished()) {
+        release(query);
+    } else {
+        pending.push_back(ticket);
+    }
+    queries[ticket] = std::move(query);
+    return ticket;
+}
+
+void SearchScheduler::update(std::chrono::microseconds budget) {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + budget;
+    while (!pending.empty() && std::chrono::steady_clock::now() < deadline) {
+        int ticket = pending.front();
+        pending.pop_front();
+        Query& query = queries[ticket];
+        if (query.search->step(slice)) {
+            release(query);
+        } else {
+            pending.push_back(ticket);
+        }
+    }
+}
+
+void SearchScheduler::release(Query& query) {
+    freeArenas.push_back(query.arena);
+    query.arena = nullptr;
+}
+
+bool SearchScheduler::isFinished(int ticket) const {
+    auto found = queries.find(ticket);
+    return found != queries.end() && found->second.search->isFinished();
+}
+
+double SearchScheduler::getProgress(int ticket) const {
+    auto found = queries.find(ticket);
+    return found != queries.end() ? found->second.search->getProgress() : 0.0;
+}
+
+int SearchScheduler::getExpansions(int ticket) const {
+    auto found = queries.find(ticket);
+    return found != queries.end() ? found->second.search->getExpansions() : 0;
+}
+
+Path SearchScheduler::take(int ticket) {
+    auto found = queries.find(ticket);
+    if (found == queries.end() || !found->second.search->isFinished()) {
+        return Path();
+    }
+    Path path = found->second.search->getPath();
+    cancel(ticket);
+    return path;
+}
+
+void SearchScheduler::cancel(int ticket) {
+    auto found = queries.find(ticket);
+    if (found == queries.end()) {
+        return;
+    }
+    if (found->second.arena != nullptr) { // still pending, or finished by a restart and not stepped since
+        release(found->second);
+        pending.erase(std::find(pending.begin(), pending.end(), ticket));
+    }
+    queries.erase(found);
+}
+
+int SearchScheduler::getPendingCount() const {
+    return pending.size();
+}
@@ -0,0 +1,64 @@
+#ifndef SEARCHSCHEDULER_HPP
+#define SEARCHSCHEDULER_HPP
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "astar/astar.hpp"
+#include "astar/grid.hpp"
+#include "astar/pathsearch.hpp"
+#include "astar/searcharena.hpp"
+
+#include "math/vec.hpp"
+
+// spreads path queries over frames: each update runs the unfinished searches in turn, a slice of expansions
+// at a time, until the frame's budget is spent, so one very long search can't hold up the frame or starve
+// the others. arenas are reused from finished searches. the scheduler listens to the grid and restarts the
+// unfinished searches that a changed cell could affect, finished paths are left as they are
+class SearchScheduler : public GridListener {
+ public:
+    // slice is the number of expansions a search runs before the next one gets a turn
+    SearchScheduler(Grid& grid, int slice = 256);
+    ~SearchScheduler();
+    SearchScheduler(const SearchScheduler&) = delete;
+    SearchScheduler& operator=(const SearchScheduler&) = delete;
+
+    void onCellChanged(int index) override;
+    void onGridReset() override;
+
+    // queues a query and returns the ticket to ask about it with
+    int submit(const Math3D::Vec3i start, const Math3D::Vec3i end);
+    // runs the unfinished searches until the budget is spent or all of them have finished
+    void update(std::chrono::microseconds budget);
+
+    bool isFinished(int ticket) const;
+    // 0 to 1, see PathSearch::getProgress
+    double getProgress(int ticket) const;
+    int getExpansions(int ticket) const;
+    // returns the path of a finished query and forgets the ticket
+    Path take(int ticket);
+    // forgets the ticket, finished or not
+    void cancel(int ticket);
+    // the number of queries not finished yet
+    int getPendingCount() const;
+ private:
+    struct Query {
+        std::unique_ptr<PathSearch> search;
+        SearchArena* arena; // nullptr once finished
+    };
+
+    Grid& grid;
+    int slice;
+    int nextTicket;
+    std::unordered_map<int, Query> queries;
+    std::deque<int> pending; // tickets of unfinished queries, in turn order
+    std::vector<std::unique_ptr<SearchArena> > arenas;
+    std::vector<SearchArena*> freeArenas;
+
+    void release(Query& query);
+};
+
+#endif
@@ -0,0 +1,460 @@
+/*
+Micro-benchmarks for the Math3D hot paths, built as the simpleEngine_bench_math target.
+
+Every benchmark applies one operation to an array of inputs and reports the time per operation.
+Hot runs repeat a pass over a small array that stays in the L1/L2 cache, cold runs evict the
+caches before each pass over a larger array so the inputs come from memory. The batch transforms
+are also run cold on an array above PARALLEL_BATCH_THRESHOLD, where they split the work across threads.
+
+Usage: simpleEngine_bench_math [--json] [--filter text] [--samples n]
+    --json      print the results as JSON instead of a table
+    --filter    only run benchmarks whose name contains the text
+    --samples   number of timed samples per run (default 11), the median is reported
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "math/math.hpp"
+
+using std::size_t;
+using namespace Math3D;
+
+namespace {
+    const size_t HOT_COUNT = 512;
+    const size_t COLD_COUNT = 32768; // below PARALLEL_BATCH_THRESHOLD so batch calls stay single threaded
+    const size_t THREADED_COUNT = 2 * PARALLEL_BATCH_THRESHOLD;
+    const size_t EVICT_BYTES = 64 * 1024 * 1024; // larger than the last level cache of our build hosts
+    const double MIN_SAMPLE_SECONDS = 0.01;
+
+    /*
+    Stops the compiler from optimizing away work whose results are never read.
+    */
+    inline void clobber() {
+    #if defined(__GNUC__)
+        asm volatile("" : : : "memory");
+    #else
+        static volatile int sink = 0;
+        sink = sink + 1;
+    #endif
+    }
+
+    struct Data {
+        std::vector<Vector4> vectors;
+        std::vector<Vector4> vectors2;
+        std::vector<Vector4> vectorsOut;
+        std::vector<Matrix4x4> matrices;
+        std::vector<Matrix4x4> matrices2;
+        std::vector<Matrix4x4> matricesOut;
+        std::vector<AffineTransform> transforms;
+        std::vector<AffineTransform> transforms2;
+        std::vector<AffineTransform> transformsOut;
+        std::vector<Quaternion> quaternions;
+        std::vector<Quaternion> quaternions2;
+        std::vector<Quaternion> quaternionsOut;
+        std::vector<float> floats;  // 3 per element
+        std::vector<float> floatsOut; // 3 per element
+        std::vector<CONTAINMENT> containment;
+        Frustum frustum;
+        TriangleBatch triangles;
+        Ray ray;
+
+        explicit Data(size_t count) {
+            std::mt19937 rng(12345);
+            std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+
+            for (size_t i = 0; i < count; ++i) {
+                vectors.push_back(Vector4(dist(rng), dist(rng), dist(rng)));
+                vectors2.push_back(Vector4(dist(rng), dist(rng), dist(rng)));
+
+                Quaternion q = Quaternion::fromEuler(dist(rng), dist(rng), dist(rng));
+                Quaternion q2 = Quaternion::fromEuler(dist(rng), dist(rng), dist(rng));
+                quaternions.push_back(q);
+                quaternions2.push_back(q2);
+
+                AffineTransform t = q.toTransform();
+                t[0][3] = dist(rng);
+                t[1][3] = dist(rng);
+                t[2][3] = dist(rng);
+                transforms.push_back(t);
+                transforms2.push_back(q2.toTransform());
+
+                matrices.push_back(t.toMatrix());
+                matrices2.push_back(q2.toMatrix());
+
+                for (int k = 0; k < 3; ++k) {
+                    floats.push_back(dist(rng));
+                }
+            }
+            vectorsOut.resize(count);
+            matricesOut.resize(count);
+            transformsOut.resize(count);
+            quaternionsOut.resize(count);
+            floatsOut.resize(count * 3);
+            containment.resize(count);
+
+            Matrix4x4 camera = Matrix4x4::fromEuler(0.3f, 0.5f, 0.0f);
+            frustum = Frustum(Matrix4x4::projection(70.0f, 16.0f / 9.0f, 0.1f, 100.0f) * camera.inverse());
+
+            for (size_t i = 0; i < count; ++i) {
+                const Vector4& c = vectors[i];
+                triangles.add(c, c + Vector4(1.0f, 0.0f, 0.0f), c + Vector4(0.0f, 1.0f, 0.0f));
+            }
+            ray = Ray(Vector4(0.0f, 0.0f, 20.0f), Vector4(0.01f, 0.02f, -1.0f));
+        }
+    };
+
+    struct Benchmark {
+        const char* name;
+        void (*run)(Data& data, size_t count);
+        bool threaded; // also run cold on THREADED_COUNT elements
+    };
+
+    const Benchmark BENCHMARKS[] = {
+        {"Vector4::operator+", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.vectorsOut[i] = d.vectors[i] + d.vectors2[i];
+            }
+        }},
+        {"Vector4::operator-", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.vectorsOut[i] = d.vectors[i] - d.vectors2[i];
+            }
+        }},
+        {"Vector4::operator*(float)", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.vectorsOut[i] = d.vectors[i] * 1.5f;
+            }
+        }},
+        {"Vector4::operator*(Vector4)", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.vectorsOut[i] = d.vectors[i] * d.vectors2[i];
+            }
+        }},
+        {"Vector4::operator/(float)", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.vectorsOut[i] = d.vectors[i] / 1.5f;
+            }
+        }},
+        {"Vector4::operator/(Vector4)", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.vectorsOut[i] = d.vectors[i] / d.vectors2[i];
+            }
+        }},
+        {"Vector4::dot", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.floatsOut[i] = d.vectors[i].dot(d.vectors2[i]);
+            }
+        }},
+        {"Vector4::cross", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.vectorsOut[i] = d.vectors[i].cross(d.vectors2[i]);
+            }
+        }},
+        {"Vector4::magnitude", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.floatsOut[i] = d.vectors[i].magnitude();
+            }
+        }},
+        {"Vector4::unit", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.vectorsOut[i] = d.vectors[i].unit();
+            }
+        }},
+        {"Matrix4x4::operator*(Matrix4x4)", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.matricesOut[i] = d.matrices[i] * d.matrices2[i];
+            }
+        }},
+        {"Matrix4x4::operator*(Vector4)", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.vectorsOut[i] = d.matrices[i] * d.vectors[i];
+            }
+        }},
+        {"Matrix4x4::inverse", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.matricesOut[i] = d.matrices[i].inverse();
+            }
+        }},
+        {"Matrix4x4::transpose", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.matricesOut[i] = d.matrices[i].transpose();
+            }
+        }},
+        {"Matrix4x4::rotation", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.matricesOut[i] = d.matrices[i].rotation();
+            }
+        }},
+        {"Matrix4x4::fromEuler", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.matricesOut[i] = Matrix4x4::fromEuler(d.floats[i*3], d.floats[i*3 + 1], d.floats[i*3 + 2]);
+            }
+        }},
+        {"Matrix4x4::projection", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.matricesOut[i] = Matrix4x4::projection(60.0f + d.floats[i*3], 1.5f, 0.1f, 100.0f);
+            }
+        }},
+        {"AffineTransform::operator*(AffineTransform)", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.transformsOut[i] = d.transforms[i] * d.transforms2[i];
+            }
+        }},
+        {"AffineTransform::operator*(Vector4)", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.vectorsOut[i] = d.transforms[i] * d.vectors[i];
+            }
+        }},
+        {"AffineTransform::inverse", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.transformsOut[i] = d.transforms[i].inverse();
+            }
+        }},
+        {"AffineTransform::orthonormalInverse", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.transformsOut[i] = d.transforms[i].orthonormalInverse();
+            }
+        }},
+        {"Quaternion::operator*", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.quaternionsOut[i] = d.quaternions[i] * d.quaternions2[i];
+            }
+        }},
+        {"Quaternion::fromEuler", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.quaternionsOut[i] = Quaternion::fromEuler(d.floats[i*3], d.floats[i*3 + 1], d.floats[i*3 + 2]);
+            }
+        }},
+        {"Quaternion::slerp", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.quaternionsOut[i] = Quaternion::slerp(d.quaternions[i], d.quaternions2[i], 0.3f);
+            }
+        }},
+        {"Quaternion::toMatrix", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.matricesOut[i] = d.quaternions[i].toMatrix();
+            }
+        }},
+        {"transformPoints(Vector4*)", [](Data& d, size_t n) {
+            transformPoints(d.matrices[0], d.vectors.data(), d.vectorsOut.data(), n);
+        }, true},
+        {"transformPoints(float*)", [](Data& d, size_t n) {
+            transformPoints(d.matrices[0], d.floats.data(), d.floatsOut.data(), n);
+        }, true},
+        {"transformDirections(Vector4*)", [](Data& d, size_t n) {
+            transformDirections(d.matrices[0], d.vectors.data(), d.vectorsOut.data(), n);
+        }, true},
+        {"transformPoint(Matrix4x4, Vec3x8)", [](Data& d, size_t n) {
+            const float* in = d.floats.data();
+            float* out = d.floatsOut.data();
+            // the first n floats of each array are read as x, the next n as y and so on
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                Vec3x8 p = Vec3x8::load(in + i, in + n + i, in + 2*n + i);
+                transformPoint(d.matrices[0], p).store(out + i, out + n + i, out + 2*n + i);
+            }
+        }},
+        {"Frustum::classifySpheres", [](Data& d, size_t n) {
+            const float* f = d.floats.data();
+            d.frustum.classifySpheres(f, f + n, f + 2*n, f + 2*n, n, d.containment.data());
+        }},
+        {"Frustum::classifyBoxes", [](Data& d, size_t n) {
+            const float* f = d.floats.data();
+            d.frustum.classifyBoxes(f, f + n, f + 2*n, f + n, f, f + 2*n, n, d.containment.data());
+        }},
+        {"Frustum::classify(AABB)", [](Data& d, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+                d.containment[i] = d.frustum.classify(AABB(d.vectors[i], d.vectors[i] + Vector4(1.0f, 1.0f, 1.0f)));
+            }
+        }},
+        {"intersect(Ray, triangle)", [](Data& d, size_t n) {
+            RayHit hit;
+            for (size_t i = 0; i < n; ++i) {
+                d.floatsOut[i] = intersect(d.ray, d.vectors[i], d.vectors2[i], d.vectors[n - 1 - i], 100.0f, hit)
+                               ? hit.t : 0.0f;
+            }
+        }}
+    };
+
+    /*
+    Writes to a buffer larger than the caches so the next pass starts cold.
+    */
+    void evictCaches() {
+        static std::vector<char> buffer(EVICT_BYTES);
+        for (size_t i = 0; i < buffer.size(); i += 64) {
+            buffer[i] = static_cast<char>(buffer[i] + 1);
+        }
+        clobber();
+    }
+
+    struct Result {
+        std::string name;
+        std::string cache;
+        size_t count;
+        double nsPerOp;
+        double minNsPerOp;
+    };
+
+    Result measure(const Benchmark& bench, Data& data, bool hot, size_t count, int samples) {
+        typedef std::chrono::steady_clock Clock;
+
+        // passes per sample, so hot samples are long enough for the clock resolution
+        size_t passes = 1;
+        if (hot) {
+            bench.run(data, count); // warm up
+            clobber();
+            for (;;) {
+                Clock::time_point start = Clock::now();
+                for (size_t p = 0; p < passes; ++p) {
+                    bench.run(data, count);
+                    clobber();
+                }
+                if (std::chrono::duration<double>(Clock::now() - start).count() >= MIN_SAMPLE_SECONDS) {
+                    break;
+                }
+                passes *= 2;
+            }
+        }
+
+        std::vector<double> times;
+        for (int s = 0; s < samples; ++s) {
+            if (!hot) {
+                evictCaches();
+            }
+            Clock::time_point start = Clock::now();
+            for (size_t p = 0; p < passes; ++p) {
+                bench.run(data, count);
+                clobber();
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            times.push_back(ns / (passes * count));
+        }
+        std::sort(times.begin(), times.end());
+
+        Result result;
+        result.name = bench.name;
+        result.cache = hot ? "hot" : count >= PARALLEL_BATCH_THRESHOLD ? "cold, threaded" : "cold";
+        result.count = count;
+        result.nsPerOp = times[times.size() / 2];
+        result.minNsPerOp = times[0];
+        return result;
+    }
+
+    const char* simdBackend() {
+    #if defined(MATH3D_SIMD_AVX)
+        return "avx";
+    #elif defined(MATH3D_SIMD_SSE)
+        return "sse";
+    #elif defined(MATH3D_SIMD_NEON)
+        return "neon";
+    #else
+        return "scalar";
+    #endif
+    }
+
+    std::string compiler() {
+    #if defined(__clang__)
+        return std::string("clang ") + __clang_version__;
+    #elif defined(__GNUC__)
+        return std::string("gcc ") + __VERSION__;
+    #elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+    #else
+        return "unknown";
+    #endif
+    }
+
+    std::string escapeJson(const std::string& s) {
+        std::string out;
+        for (size_t i = 0; i < s.size(); ++i) {
+            if (s[i] == '"' || s[i] == '\\') {
+                out += '\\';
+            }
+            out += s[i];
+        }
+        return out;
+    }
+
+    void printJson(const std::vector<Result>& results, int samples) {
+        std::cout << "{\n";
+        std::cout << "  \"compiler\": \"" << escapeJson(compiler()) << "\",\n";
+        std::cout << "  \"simd\": \"" << simdBackend() << "\",\n";
+        std::cout << "  \"samples\": " << samples << ",\n";
+        std::cout << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::cout << "    {\"name\": \"" << escapeJson(r.name) << "\", \"cache\": \"" << r.cache
+                      << "\", \"count\": " << r.count << ", \"ns_per_op\": " << r.nsPerOp
+                      << ", \"ns_per_op_min\": " << r.minNsPerOp
+                      << ", \"ops_per_second\": " << 1e9 / r.nsPerOp << "}"
+                      << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        std::cout << "  ]\n}" << std::endl;
+    }
+
+    void printTable(const std::vector<Result>& results) {
+        std::cout << "compiler: " << compiler() << ", simd: " << simdBackend() << "\n\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::string name = r.name + " (" + r.cache + ")";
+            name.resize(std::max<size_t>(name.size(), 52), ' ');
+            std::cout << name << r.nsPerOp << " ns/op, " << 1e3 / r.nsPerOp << " Mops/s\n";
+        }
+        std::cout << std::flush;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool json = false;
+    std::string filter;
+    int samples = 11;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            samples = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--json] [--filter text] [--samples n]" << std::endl;
+            return 1;
+        }
+    }
+
+    Data data(COLD_COUNT);
+    std::unique_ptr<Data> threadedData; // only built when a threaded benchmark runs, it is large
+
+    std::vector<Result> results;
+    for (size_t b = 0; b < sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]); ++b) {
+        const Benchmark& bench = BENCHMARKS[b];
+        if (!filter.empty() && std::string(bench.name).find(filter) == std::string::npos) {
+            continue;
+        }
+        results.push_back(measure(bench, data, true, HOT_COUNT, samples));
+        results.push_back(measure(bench, data, false, COLD_COUNT, samples));
+        if (bench.threaded) {
+            if (threadedData == nullptr) {
+                threadedData.reset(new Data(THREADED_COUNT));
+            }
+            results.push_back(measure(bench, *threadedData, false, THREADED_COUNT, samples));
+        }
+    }
+
+    if (json) {
+        printJson(results, samples);
+    } else {
+        printTable(results);
+    }
+
+    return 0;
+}
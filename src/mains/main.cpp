@@ -84,7 +84,6 @@ void updateCamera(Camera* cam, Window* window, float cX, float cY) {
         offset = offset * Matrix4x4(0, DELTA, 0);
     }
     Matrix4x4 newCFr = cam->getCFrame() * offset;
-    cam->setCFrame(Matrix4x4(newCFr.position())
-                    * Matrix4x4::fromEuler(0, RAD*cX, 0)
-                    * Matrix4x4::fromEuler(RAD*cY, 0, 0));
+    Quaternion rotation = Quaternion::fromEuler(0, RAD*cX, 0) * Quaternion::fromEuler(RAD*cY, 0, 0);
+    cam->setTransform(RigidTransform(rotation, newCFr.position()).toTransform());
 }
@@ -0,0 +1,154 @@
+#include "math/aabb.hpp"
+
+#include <limits>
+
+#include "math/simd.hpp"
+
+using std::size_t;
+using namespace Math3D;
+
+namespace {
+    const float INF = std::numeric_limits<float>::infinity();
+
+    /*
+    Returns the box with corners from SIMD vectors, forcing w back to 1.
+    */
+    AABB fromLanes(SIMD::float4 lo, SIMD::float4 hi) {
+        Vector4 min, max;
+        SIMD::store(min.getValues(), lo);
+        SIMD::store(max.getValues(), hi);
+        min[3] = 1.0f;
+        max[3] = 1.0f;
+        return AABB(min, max);
+    }
+}
+
+AABB::AABB() : min(INF, INF, INF), max(-INF, -INF, -INF) {}
+
+AABB::AABB(const Vector4& mn, const Vector4& mx) : min(mn), max(mx) {}
+
+AABB AABB::fromPoints(const Vector4* points, size_t count) {
+    SIMD::float4 lo = SIMD::splat(INF);
+    SIMD::float4 hi = SIMD::splat(-INF);
+    for (size_t i = 0; i < count; ++i) {
+        SIMD::float4 p = SIMD::load(points[i].getValues());
+        lo = SIMD::min(lo, p);
+        hi = SIMD::max(hi, p);
+    }
+    return fromLanes(lo, hi);
+}
+
+AABB AABB::fromPoints(const Vec3f* points, size_t count) {
+    if (count == 0) {
+        return AABB();
+    }
+
+    SIMD::float4 lo = SIMD::splat(INF);
+    SIMD::float4 hi = SIMD::splat(-INF);
+    // a 4 float load of a packed point also reads the next point's x, which only affects the ignored w lane,
+    // but the last point has nothing after it so it is loaded separately
+    const float* data = points[0].getValues();
+    for (size_t i = 0; i + 1 < count; ++i) {
+        SIMD::float4 p = SIMD::loadUnaligned(data + i*3);
+        lo = SIMD::min(lo, p);
+        hi = SIMD::max(hi, p);
+    }
+    const Vec3f& last = points[count - 1];
+    SIMD::float4 p = SIMD::set(last[0], last[1], last[2], 0.0f);
+    return fromLanes(SIMD::min(lo, p), SIMD::max(hi, p));
+}
+
+bool AABB::isEmpty() const {
+    return min[0] > max[0] || min[1] > max[1] || min[2] > max[2];
+}
+
+Vector4 AABB::getCenter() const {
+    Vector4 out = (min + max) * 0.5f;
+    out[3] = 1.0f;
+    return out;
+}
+
+Vector4 AABB::getExtents() const {
+    Vector4 out = (max - min) * 0.5f;
+    out[3] = 1.0f;
+    return out;
+}
+
+AABB AABB::scale(const Vector4& factors) const {
+    if (isEmpty()) {
+        return *this;
+    }
+    SIMD::float4 f = SIMD::load(factors.getValues());
+    SIMD::float4 a = SIMD::mul(SIMD::load(min.getValues()), f);
+    SIMD::float4 b = SIMD::mul(SIMD::load(max.getValues()), f);
+    // negative factors swap which corner is the minimum
+    return fromLanes(SIMD::min(a, b), SIMD::max(a, b));
+}
+
+AABB AABB::transform(const Matrix4x4& mat) const {
+    return transformRows(mat[0], mat[1], mat[2]);
+}
+
+AABB AABB::transform(const AffineTransform& transform) const {
+    return transformRows(transform[0], transform[1], transform[2]);
+}
+
+AABB AABB::transformRows(const float* r0, const float* r1, const float* r2) const {
+    if (isEmpty()) {
+        return *this;
+    }
+
+    // Arvo: the new center is the transformed center and the new extents are |R| * extents
+    SIMD::float4 c0 = SIMD::load(r0);
+    SIMD::float4 c1 = SIMD::load(r1);
+    SIMD::float4 c2 = SIMD::load(r2);
+    SIMD::float4 c3 = SIMD::splat(0.0f);
+    SIMD::transpose(c0, c1, c2, c3); // c3 is now the translation
+
+    Vector4 center = getCenter();
+    Vector4 extents = getExtents();
+
+    SIMD::float4 newCenter = SIMD::add(c3, SIMD::mul(c0, SIMD::splat(center[0])));
+    newCenter = SIMD::add(newCenter, SIMD::mul(c1, SIMD::splat(center[1])));
+    newCenter = SIMD::add(newCenter, SIMD::mul(c2, SIMD::splat(center[2])));
+
+    SIMD::float4 newExtents = SIMD::mul(SIMD::abs(c0), SIMD::splat(extents[0]));
+    newExtents = SIMD::add(newExtents, SIMD::mul(SIMD::abs(c1), SIMD::splat(extents[1])));
+    newExtents = SIMD::add(newExtents, SIMD::mul(SIMD::abs(c2), SIMD::splat(extents[2])));
+
+    return fromLanes(SIMD::sub(newCenter, newExtents), SIMD::add(newCenter, newExtents));
+}
+
+AABB AABB::merge(const AABB& b) const {
+    return fromLanes(SIMD::min(SIMD::load(min.getValues()), SIMD::load(b.min.getValues())),
+                     SIMD::max(SIMD::load(max.getValues()), SIMD::load(b.max.getValues())));
+}
+
+AABB AABB::merge(const Vector4& point) const {
+    SIMD::float4 p = SIMD::load(point.getValues());
+    return fromLanes(SIMD::min(SIMD::load(min.getValues()), p), SIMD::max(SIMD::load(max.getValues()), p));
+}
+
+bool AABB::overlaps(const AABB& b) const {
+    return min[0] <= b.max[0] && max[0] >= b.min[0]
+        && min[1] <= b.max[1] && max[1] >= b.min[1]
+        && min[2] <= b.max[2] && max[2] >= b.min[2];
+}
+
+bool AABB::contains(const AABB& b) const {
+    return min[0] <= b.min[0] && max[0] >= b.max[0]
+        && min[1] <= b.min[1] && max[1] >= b.max[1]
+        && min[2] <= b.min[2] && max[2] >= b.max[2];
+}
+
+bool AABB::contains(const Vector4& point) const {
+    return min[0] <= point[0] && point[0] <= max[0]
+        && min[1] <= point[1] && point[1] <= max[1]
+        && min[2] <= point[2] && point[2] <= max[2];
+}
+
+std::ostream& Math3D::operator <<(std::ostream &outs, const AABB &box) {
+    outs << box.getMin() << ", " << box.getMax();
+
+    return outs;
+}
@@ -0,0 +1,87 @@
+#ifndef AABB_HPP
+#define AABB_HPP
+
+#include <cstddef>
+#include <iostream>
+
+#include "math/affinetransform.hpp"
+#include "math/matrix4x4.hpp"
+#include "math/vec.hpp"
+#include "math/vector4.hpp"
+
+namespace Math3D {
+    /*
+    An axis aligned bounding box, stored as its minimum and maximum corners.
+    */
+    class AABB {
+     public:
+        /*
+        Returns an empty box, which contains nothing and merges into anything.
+        */
+        AABB();
+        /*
+        Returns the box with the given corners.
+        */
+        AABB(const Vector4& min, const Vector4& max);
+        /*
+        Returns the smallest box containing the points.
+        */
+        static AABB fromPoints(const Vector4* points, std::size_t count);
+        static AABB fromPoints(const Vec3f* points, std::size_t count);
+        /*
+        Returns whether the box is empty (contains no points).
+        */
+        bool isEmpty() const;
+
+        const Vector4& getMin() const { return min; }
+        const Vector4& getMax() const { return max; }
+        /*
+        Returns the center of the box.
+        */
+        Vector4 getCenter() const;
+        /*
+        Returns half of the box's size along each axis.
+        */
+        Vector4 getExtents() const;
+        /*
+        Returns the box scaled component-wise (about the origin) by the vector.
+        */
+        AABB scale(const Vector4& factors) const;
+        /*
+        Returns the smallest box containing this box transformed by the matrix (Arvo's method).
+        The matrix is assumed to be affine.
+        */
+        AABB transform(const Matrix4x4& mat) const;
+        AABB transform(const AffineTransform& transform) const;
+        /*
+        Returns the smallest box containing both boxes.
+        */
+        AABB merge(const AABB& b) const;
+        /*
+        Returns the smallest box containing this box and the point.
+        */
+        AABB merge(const Vector4& point) const;
+        /*
+        Returns whether the boxes overlap (touching counts as overlapping).
+        */
+        bool overlaps(const AABB& b) const;
+        /*
+        Returns whether the box entirely contains the other box.
+        */
+        bool contains(const AABB& b) const;
+        /*
+        Returns whether the box contains the point.
+        */
+        bool contains(const Vector4& point) const;
+
+     private:
+        Vector4 min;
+        Vector4 max;
+
+        AABB transformRows(const float* r0, const float* r1, const float* r2) const;
+    };
+
+    std::ostream& operator <<(std::ostream &outs, const AABB &box);
+}
+
+#endif
@@ -0,0 +1,202 @@
+#include "math/affinetransform.hpp"
+
+#include <cmath>
+
+#include "math/constants.hpp"
+
+using namespace Math3D;
+
+AffineTransform::AffineTransform() {
+    values[0][0] = 1.0f;
+    values[0][1] = 0.0f;
+    values[0][2] = 0.0f;
+    values[0][3] = 0.0f;
+    values[1][0] = 0.0f;
+    values[1][1] = 1.0f;
+    values[1][2] = 0.0f;
+    values[1][3] = 0.0f;
+    values[2][0] = 0.0f;
+    values[2][1] = 0.0f;
+    values[2][2] = 1.0f;
+    values[2][3] = 0.0f;
+}
+
+AffineTransform::AffineTransform(const Vector4& vector) {
+    values[0][0] = 1.0f;
+    values[0][1] = 0.0f;
+    values[0][2] = 0.0f;
+    values[0][3] = vector[0];
+    values[1][0] = 0.0f;
+    values[1][1] = 1.0f;
+    values[1][2] = 0.0f;
+    values[1][3] = vector[1];
+    values[2][0] = 0.0f;
+    values[2][1] = 0.0f;
+    values[2][2] = 1.0f;
+    values[2][3] = vector[2];
+}
+
+AffineTransform::AffineTransform(float x, float y, float z) {
+    values[0][0] = 1.0f;
+    values[0][1] = 0.0f;
+    values[0][2] = 0.0f;
+    values[0][3] = x;
+    values[1][0] = 0.0f;
+    values[1][1] = 1.0f;
+    values[1][2] = 0.0f;
+    values[1][3] = y;
+    values[2][0] = 0.0f;
+    values[2][1] = 0.0f;
+    values[2][2] = 1.0f;
+    values[2][3] = z;
+}
+
+AffineTransform::AffineTransform(float x, float y, float z, float r00, float r01, float r02, float r10, float r11, float r12, float r20, float r21, float r22) {
+    values[0][3] = x;
+    values[1][3] = y;
+    values[2][3] = z;
+
+    values[0][0] = r00;
+    values[0][1] = r01;
+    values[0][2] = r02;
+    values[1][0] = r10;
+    values[1][1] = r11;
+    values[1][2] = r12;
+    values[2][0] = r20;
+    values[2][1] = r21;
+    values[2][2] = r22;
+}
+
+AffineTransform::AffineTransform(const Matrix4x4& mat) {
+    SIMD::store(values[0], SIMD::load(mat[0]));
+    SIMD::store(values[1], SIMD::load(mat[1]));
+    SIMD::store(values[2], SIMD::load(mat[2]));
+}
+
+Matrix4x4 AffineTransform::toMatrix() const {
+    Matrix4x4 out;
+
+    SIMD::store(out[0], SIMD::load(values[0]));
+    SIMD::store(out[1], SIMD::load(values[1]));
+    SIMD::store(out[2], SIMD::load(values[2]));
+
+    return out;
+}
+
+AffineTransform AffineTransform::inverse() const {
+    float det = -values[0][2] * values[1][1] * values[2][0] + values[0][1] * values[1][2] * values[2][0]
+                + values[0][2] * values[1][0] * values[2][1] - values[0][0] * values[1][2] * values[2][1]
+                - values[0][1] * values[1][0] * values[2][2] + values[0][0] * values[1][1] * values[2][2];
+    float k = 1/det;
+
+    // the rows of the inverted rotation are the cross products of the columns
+    SIMD::float4 c0 = SIMD::load(values[0]);
+    SIMD::float4 c1 = SIMD::load(values[1]);
+    SIMD::float4 c2 = SIMD::load(values[2]);
+    SIMD::float4 c3 = SIMD::splat(0.0f);
+    SIMD::transpose(c0, c1, c2, c3);
+
+    SIMD::float4 scale = SIMD::splat(k);
+    SIMD::float4 r0 = SIMD::mul(SIMD::cross3(c1, c2), scale);
+    SIMD::float4 r1 = SIMD::mul(SIMD::cross3(c2, c0), scale);
+    SIMD::float4 r2 = SIMD::mul(SIMD::cross3(c0, c1), scale);
+
+    AffineTransform out;
+    SIMD::store(out.values[0], r0);
+    SIMD::store(out.values[1], r1);
+    SIMD::store(out.values[2], r2);
+
+    // translation is the negated inverse rotation applied to the original translation
+    SIMD::float4 r3 = SIMD::splat(0.0f);
+    SIMD::transpose(r0, r1, r2, r3);
+    alignas(16) float translation[4];
+    SIMD::float4 t = SIMD::mul(r0, SIMD::splat(values[0][3]));
+    t = SIMD::add(t, SIMD::mul(r1, SIMD::splat(values[1][3])));
+    t = SIMD::add(t, SIMD::mul(r2, SIMD::splat(values[2][3])));
+    SIMD::store(translation, SIMD::mul(t, SIMD::splat(-1.0f)));
+
+    out.values[0][3] = translation[0];
+    out.values[1][3] = translation[1];
+    out.values[2][3] = translation[2];
+
+    return out;
+}
+
+AffineTransform AffineTransform::orthonormalInverse() const {
+    SIMD::float4 r0 = SIMD::load(values[0]);
+    SIMD::float4 r1 = SIMD::load(values[1]);
+    SIMD::float4 r2 = SIMD::load(values[2]);
+
+    // the inverse position is -(R^T * p), which is the sum of R's rows scaled by p's components
+    alignas(16) float translation[4];
+    SIMD::float4 t = SIMD::mul(r0, SIMD::splat(values[0][3]));
+    t = SIMD::add(t, SIMD::mul(r1, SIMD::splat(values[1][3])));
+    t = SIMD::add(t, SIMD::mul(r2, SIMD::splat(values[2][3])));
+    SIMD::store(translation, SIMD::mul(t, SIMD::splat(-1.0f)));
+
+    SIMD::float4 r3 = SIMD::splat(0.0f);
+    SIMD::transpose(r0, r1, r2, r3);
+
+    AffineTransform out;
+    SIMD::store(out.values[0], r0);
+    SIMD::store(out.values[1], r1);
+    SIMD::store(out.values[2], r2);
+    out.values[0][3] = translation[0];
+    out.values[1][3] = translation[1];
+    out.values[2][3] = translation[2];
+
+    return out;
+}
+
+Vector4 AffineTransform::lookvector() const {
+    Vector4 out;
+
+    out[0] = -values[0][2];
+    out[1] = -values[1][2];
+    out[2] = -values[2][2];
+    out[3] = 1.0f;
+
+    return out;
+}
+
+Vector4 AffineTransform::position() const {
+    return Vector4(values[0][3], values[1][3], values[2][3]);
+}
+
+AffineTransform AffineTransform::rotation() const {
+    AffineTransform out = *this;
+
+    out.values[0][3] = 0.0f;
+    out.values[1][3] = 0.0f;
+    out.values[2][3] = 0.0f;
+
+    return out;
+}
+
+bool AffineTransform::operator==(const AffineTransform& b) const {
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 4; column++) {
+            if (fabs(values[row][column] - b.values[row][column]) > EPSILON) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool AffineTransform::operator!=(const AffineTransform& b) const {
+    return !operator==(b);
+}
+
+std::ostream& Math3D::operator <<(std::ostream &outs, const AffineTransform &transform) {
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 4; column++) {
+            outs << transform[row][column];
+            if (column < 3 || row < 2) {
+                outs << ", ";
+            }
+        }
+    }
+
+    return outs;
+}
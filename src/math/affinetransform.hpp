@@ -0,0 +1,143 @@
+#ifndef AFFINETRANSFORM_HPP
+#define AFFINETRANSFORM_HPP
+
+#include <iostream>
+
+#include "math/matrix4x4.hpp"
+#include "math/simd.hpp"
+#include "math/vector4.hpp"
+
+namespace Math3D {
+    /*
+    An affine transform stored as the top 3 rows of a 4x4 matrix (rotation/scale in the first three
+    columns and the position in the last). The implied bottom row is always 0, 0, 0, 1.
+    */
+    class AffineTransform {
+     public:
+        /*
+        Returns identity transform.
+        */
+        AffineTransform();
+        /*
+        Returns transform with a position at the given vector with no rotation.
+        */
+        AffineTransform(const Vector4& vector);
+        /*
+        Returns transform at position x, y, z with no rotation.
+        */
+        AffineTransform(float x, float y, float z);
+        /*
+        Returns transform with its values set as given ones.
+        */
+        AffineTransform(float x, float y, float z, float r00, float r01, float r02, float r10, float r11, float r12, float r20, float r21, float r22);
+        /*
+        Returns transform from the top 3 rows of the matrix. The matrix's bottom row is ignored.
+        */
+        explicit AffineTransform(const Matrix4x4& mat);
+        /*
+        Returns the full 4x4 matrix of the transform.
+        */
+        Matrix4x4 toMatrix() const;
+        /*
+        Returns the inverse of the transform.
+        */
+        AffineTransform inverse() const;
+        /*
+        Returns the inverse of the transform, assuming the rotation part is orthonormal (no scale or shear).
+        This only transposes the rotation, so it is cheaper than inverse().
+        */
+        AffineTransform orthonormalInverse() const;
+        /*
+        Returns the forward unit vector from the transform's rotation.
+        */
+        Vector4 lookvector() const;
+        /*
+        Returns the position of the transform.
+        */
+        Vector4 position() const;
+        /*
+        Returns the rotation of the transform.
+        */
+        AffineTransform rotation() const;
+        /*
+        Returns the transform that results from this transform being composed with another (this * b).
+        */
+        AffineTransform operator*(const AffineTransform& b) const;
+        /*
+        Returns the vector that results from this transform being multiplied by a vector. The vector's w
+        scales the position, so a w of 0 transforms a direction.
+        */
+        Vector4 operator*(const Vector4& b) const;
+
+        bool operator==(const AffineTransform&) const;
+
+        bool operator!=(const AffineTransform&) const;
+        /*
+        Allows the transform's values to be indexed like Transform[row][column], row < 3
+        */
+        float* operator[](int);
+        const float* operator[](int) const;
+        /*
+        Returns pointer to the transform's value array
+        */
+        float* getValues();
+        const float* getValues() const;
+
+     private:
+        alignas(16) float values[3][4];
+    };
+
+    std::ostream& operator <<(std::ostream &outs, const AffineTransform &transform);
+
+    inline AffineTransform AffineTransform::operator*(const AffineTransform& b) const {
+        AffineTransform out;
+
+        SIMD::float4 b0 = SIMD::load(b.values[0]);
+        SIMD::float4 b1 = SIMD::load(b.values[1]);
+        SIMD::float4 b2 = SIMD::load(b.values[2]);
+
+        // b's implied bottom row only contributes this row's position
+        for (int row = 0; row < 3; ++row) {
+            SIMD::float4 sum = SIMD::mul(SIMD::splat(values[row][0]), b0);
+            sum = SIMD::add(sum, SIMD::mul(SIMD::splat(values[row][1]), b1));
+            sum = SIMD::add(sum, SIMD::mul(SIMD::splat(values[row][2]), b2));
+            SIMD::store(out.values[row], sum);
+            out.values[row][3] += values[row][3];
+        }
+
+        return out;
+    }
+
+    inline Vector4 AffineTransform::operator*(const Vector4& b) const {
+        Vector4 out;
+
+        SIMD::float4 vec = SIMD::load(b.getValues());
+        SIMD::float4 p0 = SIMD::mul(SIMD::load(values[0]), vec);
+        SIMD::float4 p1 = SIMD::mul(SIMD::load(values[1]), vec);
+        SIMD::float4 p2 = SIMD::mul(SIMD::load(values[2]), vec);
+        SIMD::float4 p3 = SIMD::splat(0.0f);
+        SIMD::transpose(p0, p1, p2, p3);
+        SIMD::store(out.getValues(), SIMD::add(SIMD::add(SIMD::add(p0, p1), p2), p3));
+        out[3] = b[3];
+
+        return out;
+    }
+
+    inline float* AffineTransform::operator[](int row) {
+        return values[row];
+    }
+
+    inline const float* AffineTransform::operator[](int row) const {
+        return values[row];
+    }
+
+    inline float* AffineTransform::getValues() {
+        return *values;
+    }
+
+    inline const float* AffineTransform::getValues() const {
+        return *values;
+    }
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include "math/batch.hpp"
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "math/simd.hpp"
+
+using std::size_t;
+using namespace Math3D;
+
+namespace {
+    /*
+    The matrix columns, so that a transform is a sum of the columns scaled by x, y, z (and w).
+    */
+    struct Columns {
+        SIMD::float4 c0, c1, c2, c3;
+
+        Columns(const Matrix4x4& mat) {
+            c0 = SIMD::load(mat[0]);
+            c1 = SIMD::load(mat[1]);
+            c2 = SIMD::load(mat[2]);
+            c3 = SIMD::load(mat[3]);
+            SIMD::transpose(c0, c1, c2, c3);
+        }
+
+        SIMD::float4 point(float x, float y, float z) const {
+            SIMD::float4 sum = SIMD::mul(c0, SIMD::splat(x));
+            sum = SIMD::add(sum, SIMD::mul(c1, SIMD::splat(y)));
+            sum = SIMD::add(sum, SIMD::mul(c2, SIMD::splat(z)));
+            return SIMD::add(sum, c3);
+        }
+
+        SIMD::float4 direction(float x, float y, float z) const {
+            SIMD::float4 sum = SIMD::mul(c0, SIMD::splat(x));
+            sum = SIMD::add(sum, SIMD::mul(c1, SIMD::splat(y)));
+            return SIMD::add(sum, SIMD::mul(c2, SIMD::splat(z)));
+        }
+    };
+
+    void pointsVec4(const Columns& cols, const Vector4* in, Vector4* out, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const float* p = in[i].getValues();
+            SIMD::store(out[i].getValues(), cols.point(p[0], p[1], p[2]));
+        }
+    }
+
+    void directionsVec4(const Columns& cols, const Vector4* in, Vector4* out, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const float* p = in[i].getValues();
+            SIMD::store(out[i].getValues(), cols.direction(p[0], p[1], p[2]));
+            out[i][3] = 0.0f;
+        }
+    }
+
+    void pointsPacked(const Columns& cols, const float* in, float* out, size_t begin, size_t end) {
+        alignas(16) float result[4];
+        for (size_t i = begin; i < end; ++i) {
+            const float* p = in + i*3;
+            // a full 4 float store would run into the next (possibly not yet read) element
+            SIMD::store(result, cols.point(p[0], p[1], p[2]));
+            out[i*3] = result[0];
+            out[i*3 + 1] = result[1];
+            out[i*3 + 2] = result[2];
+        }
+    }
+
+    void directionsPacked(const Columns& cols, const float* in, float* out, size_t begin, size_t end) {
+        alignas(16) float result[4];
+        for (size_t i = begin; i < end; ++i) {
+            const float* p = in + i*3;
+            SIMD::store(result, cols.direction(p[0], p[1], p[2]));
+            out[i*3] = result[0];
+            out[i*3 + 1] = result[1];
+            out[i*3 + 2] = result[2];
+        }
+    }
+
+    /*
+    Runs kernel over [0, count), splitting the range between threads when it is large enough.
+    */
+    template <typename In, typename Out>
+    void dispatch(void (*kernel)(const Columns&, const In*, Out*, size_t, size_t),
+                  const Matrix4x4& mat, const In* in, Out* out, size_t count) {
+        Columns cols(mat);
+
+        // hardware_concurrency is a system call on some platforms, so small batches return before asking
+        if (count < PARALLEL_BATCH_THRESHOLD) {
+            kernel(cols, in, out, 0, count);
+            return;
+        }
+        size_t numThreads = std::thread::hardware_concurrency();
+        if (numThreads < 2) {
+            kernel(cols, in, out, 0, count);
+            return;
+        }
+
+        size_t chunk = (count + numThreads - 1) / numThreads;
+        std::vector<std::thread> workers;
+        workers.reserve(numThreads - 1);
+        for (size_t begin = chunk; begin < count; begin += chunk) {
+            size_t end = begin + chunk < count ? begin + chunk : count;
+            workers.push_back(std::thread(kernel, std::cref(cols), in, out, begin, end));
+        }
+        kernel(cols, in, out, 0, chunk); // the calling thread takes the first chunk
+
+        for (unsigned int i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+    }
+}
+
+void Math3D::transformPoints(const Matrix4x4& mat, const Vector4* in, Vector4* out, size_t count) {
+    dispatch(pointsVec4, mat, in, out, count);
+}
+
+void Math3D::transformPoints(const Matrix4x4& mat, const float* in, float* out, size_t count) {
+    dispatch(pointsPacked, mat, in, out, count);
+}
+
+void Math3D::transformDirections(const Matrix4x4& mat, const Vector4* in, Vector4* out, size_t count) {
+    dispatch(directionsVec4, mat, in, out, count);
+}
+
+void Math3D::transformDirections(const Matrix4x4& mat, const float* in, float* out, size_t count) {
+    dispatch(directionsPacked, mat, in, out, count);
+}
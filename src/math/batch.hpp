@@ -0,0 +1,36 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <cstddef>
+
+#include "math/matrix4x4.hpp"
+#include "math/vector4.hpp"
+
+namespace Math3D {
+    /*
+    Arrays with at least this many elements are split across all hardware threads.
+    */
+    const std::size_t PARALLEL_BATCH_THRESHOLD = 65536;
+
+    /*
+    Transforms count points by the matrix, treating each point's w as 1. The result of each point
+    is the same as mat * Vector4(x, y, z). The input and output arrays may be the same array.
+    */
+    void transformPoints(const Matrix4x4& mat, const Vector4* in, Vector4* out, std::size_t count);
+    /*
+    Transforms count packed x, y, z points (3 floats per point) by the matrix, treating w as 1.
+    The projective w of the result is discarded, so this is meant for affine matrices.
+    */
+    void transformPoints(const Matrix4x4& mat, const float* in, float* out, std::size_t count);
+    /*
+    Transforms count directions by the matrix, treating each direction's w as 0 (so translation is ignored).
+    The output w is set to 0. The input and output arrays may be the same array.
+    */
+    void transformDirections(const Matrix4x4& mat, const Vector4* in, Vector4* out, std::size_t count);
+    /*
+    Transforms count packed x, y, z directions (3 floats per direction) by the matrix, ignoring translation.
+    */
+    void transformDirections(const Matrix4x4& mat, const float* in, float* out, std::size_t count);
+}
+
+#endif
@@ -0,0 +1,149 @@
+#include "math/boundingsphere.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "math/simd.hpp"
+
+using std::size_t;
+using namespace Math3D;
+
+namespace {
+    /*
+    Returns the largest squared distance from the center to any of the points.
+    */
+    float maxDistanceSquared(const Vector4& center, const Vector4* points, size_t count) {
+        SIMD::float4 c = SIMD::load(center.getValues());
+        SIMD::float4 best = SIMD::splat(0.0f);
+        for (size_t i = 0; i < count; ++i) {
+            SIMD::float4 d = SIMD::sub(SIMD::load(points[i].getValues()), c);
+            best = SIMD::max(best, SIMD::splat(SIMD::dot3(d, d)));
+        }
+        return SIMD::first(best);
+    }
+
+    float maxDistanceSquared(const Vector4& center, const Vec3f* points, size_t count) {
+        SIMD::float4 c = SIMD::load(center.getValues());
+        float best = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            SIMD::float4 d = SIMD::sub(SIMD::set(points[i][0], points[i][1], points[i][2], 1.0f), c);
+            best = std::max(best, SIMD::dot3(d, d));
+        }
+        return best;
+    }
+
+    /*
+    Returns the largest squared length of the first three columns of the rows.
+    */
+    float maxScaleSquared(const float* r0, const float* r1, const float* r2) {
+        float best = 0.0f;
+        for (int col = 0; col < 3; ++col) {
+            best = std::max(best, r0[col]*r0[col] + r1[col]*r1[col] + r2[col]*r2[col]);
+        }
+        return best;
+    }
+}
+
+BoundingSphere::BoundingSphere() : center(), radius(-1.0f) {}
+
+BoundingSphere::BoundingSphere(const Vector4& c, float r) : center(c), radius(r) {}
+
+BoundingSphere BoundingSphere::fromPoints(const Vector4* points, size_t count) {
+    AABB box = AABB::fromPoints(points, count);
+    if (box.isEmpty()) {
+        return BoundingSphere();
+    }
+    Vector4 c = box.getCenter();
+    return BoundingSphere(c, std::sqrt(maxDistanceSquared(c, points, count)));
+}
+
+BoundingSphere BoundingSphere::fromPoints(const Vec3f* points, size_t count) {
+    AABB box = AABB::fromPoints(points, count);
+    if (box.isEmpty()) {
+        return BoundingSphere();
+    }
+    Vector4 c = box.getCenter();
+    return BoundingSphere(c, std::sqrt(maxDistanceSquared(c, points, count)));
+}
+
+BoundingSphere BoundingSphere::fromAABB(const AABB& box) {
+    if (box.isEmpty()) {
+        return BoundingSphere();
+    }
+    return BoundingSphere(box.getCenter(), box.getExtents().magnitude());
+}
+
+bool BoundingSphere::isEmpty() const {
+    return radius < 0.0f;
+}
+
+BoundingSphere BoundingSphere::transform(const Matrix4x4& mat) const {
+    if (isEmpty()) {
+        return *this;
+    }
+    return BoundingSphere(mat * center, radius * std::sqrt(maxScaleSquared(mat[0], mat[1], mat[2])));
+}
+
+BoundingSphere BoundingSphere::transform(const AffineTransform& transform) const {
+    if (isEmpty()) {
+        return *this;
+    }
+    return BoundingSphere(transform * center,
+                          radius * std::sqrt(maxScaleSquared(transform[0], transform[1], transform[2])));
+}
+
+BoundingSphere BoundingSphere::merge(const BoundingSphere& b) const {
+    if (isEmpty()) {
+        return b;
+    } else if (b.isEmpty()) {
+        return *this;
+    }
+
+    Vector4 offset = b.center - center;
+    float dist = offset.magnitude();
+    if (dist + b.radius <= radius) {
+        return *this;
+    } else if (dist + radius <= b.radius) {
+        return b;
+    }
+
+    float newRadius = (dist + radius + b.radius) * 0.5f;
+    Vector4 newCenter = center + offset * ((newRadius - radius) / dist);
+    newCenter[3] = 1.0f;
+    return BoundingSphere(newCenter, newRadius);
+}
+
+bool BoundingSphere::overlaps(const BoundingSphere& b) const {
+    if (isEmpty() || b.isEmpty()) {
+        return false;
+    }
+    Vector4 offset = b.center - center;
+    float r = radius + b.radius;
+    return offset.dot(offset) <= r*r;
+}
+
+bool BoundingSphere::overlaps(const AABB& box) const {
+    if (isEmpty() || box.isEmpty()) {
+        return false;
+    }
+    // squared distance from the center to the closest point of the box
+    SIMD::float4 c = SIMD::load(center.getValues());
+    SIMD::float4 closest = SIMD::min(SIMD::max(c, SIMD::load(box.getMin().getValues())),
+                                     SIMD::load(box.getMax().getValues()));
+    SIMD::float4 d = SIMD::sub(c, closest);
+    return SIMD::dot3(d, d) <= radius*radius;
+}
+
+bool BoundingSphere::contains(const Vector4& point) const {
+    if (isEmpty()) {
+        return false;
+    }
+    Vector4 offset = point - center;
+    return offset.dot(offset) <= radius*radius;
+}
+
+std::ostream& Math3D::operator <<(std::ostream &outs, const BoundingSphere &sphere) {
+    outs << sphere.getCenter() << ", " << sphere.getRadius();
+
+    return outs;
+}
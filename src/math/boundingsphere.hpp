@@ -0,0 +1,73 @@
+#ifndef BOUNDINGSPHERE_HPP
+#define BOUNDINGSPHERE_HPP
+
+#include <cstddef>
+#include <iostream>
+
+#include "math/aabb.hpp"
+#include "math/affinetransform.hpp"
+#include "math/matrix4x4.hpp"
+#include "math/vec.hpp"
+#include "math/vector4.hpp"
+
+namespace Math3D {
+    /*
+    A bounding sphere, stored as its center and radius. A negative radius marks an empty sphere.
+    */
+    class BoundingSphere {
+     public:
+        /*
+        Returns an empty sphere, which contains nothing and merges into anything.
+        */
+        BoundingSphere();
+        BoundingSphere(const Vector4& center, float radius);
+        /*
+        Returns a sphere containing the points, centered on their bounding box. This is not the
+        minimal sphere but is cheap to compute and usually close.
+        */
+        static BoundingSphere fromPoints(const Vector4* points, std::size_t count);
+        static BoundingSphere fromPoints(const Vec3f* points, std::size_t count);
+        /*
+        Returns the sphere circumscribing the box.
+        */
+        static BoundingSphere fromAABB(const AABB& box);
+        /*
+        Returns whether the sphere is empty (contains no points).
+        */
+        bool isEmpty() const;
+
+        const Vector4& getCenter() const { return center; }
+        float getRadius() const { return radius; }
+        /*
+        Returns a sphere containing this sphere transformed by the matrix. The radius is scaled by the
+        largest axis scale of the matrix, so the matrix is assumed to have no shear (rotation, scale and
+        translation only).
+        */
+        BoundingSphere transform(const Matrix4x4& mat) const;
+        BoundingSphere transform(const AffineTransform& transform) const;
+        /*
+        Returns the smallest sphere containing both spheres.
+        */
+        BoundingSphere merge(const BoundingSphere& b) const;
+        /*
+        Returns whether the spheres overlap (touching counts as overlapping).
+        */
+        bool overlaps(const BoundingSphere& b) const;
+        /*
+        Returns whether the sphere overlaps the box.
+        */
+        bool overlaps(const AABB& box) const;
+        /*
+        Returns whether the sphere contains the point.
+        */
+        bool contains(const Vector4& point) const;
+
+     private:
+        Vector4 center;
+        float radius;
+    };
+
+    std::ostream& operator <<(std::ostream &outs, const BoundingSphere &sphere);
+}
+
+#endif
@@ -0,0 +1,196 @@
+#include "math/frustum.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include "math/packet.hpp"
+
+using std::size_t;
+using namespace Math3D;
+
+namespace {
+    const float INF = std::numeric_limits<float>::infinity();
+
+    /*
+    Turns the smallest distances to the planes of the nearest and farthest points of a volume into a result.
+    */
+    inline CONTAINMENT toContainment(float nearest, float farthest) {
+        if (nearest < 0.0f) {
+            return CONTAINMENT::OUTSIDE;
+        } else if (farthest >= 0.0f) {
+            return CONTAINMENT::INSIDE;
+        }
+        return CONTAINMENT::INTERSECTING;
+    }
+
+    /*
+    Classifies volumes from index start in blocks of W::WIDTH, returning the index of the first volume not done.
+    Boxes are treated like spheres whose radius is the box's extents projected onto each plane normal.
+    */
+    template <typename W>
+    size_t classifySpheresWide(const float (&planes)[6][4], const float* x, const float* y, const float* z,
+                               const float* radius, size_t start, size_t count, CONTAINMENT* out) {
+        typedef FloatPacket<W> Float;
+        typedef Vec3Packet<W> Vec3;
+
+        size_t i = start;
+        for (; i + W::WIDTH <= count; i += W::WIDTH) {
+            Vec3 center = Vec3::load(x + i, y + i, z + i);
+            Float r = Float::load(radius + i);
+            Float nearest(INF), farthest(INF);
+            for (int p = 0; p < 6; ++p) {
+                Float dist = center.dot(Vec3(planes[p][0], planes[p][1], planes[p][2])) + Float(planes[p][3]);
+                nearest = min(nearest, dist + r);
+                farthest = min(farthest, dist - r);
+            }
+
+            float n[W::WIDTH], f[W::WIDTH];
+            nearest.store(n);
+            farthest.store(f);
+            for (int j = 0; j < W::WIDTH; ++j) {
+                out[i + j] = toContainment(n[j], f[j]);
+            }
+        }
+        return i;
+    }
+
+    template <typename W>
+    size_t classifyBoxesWide(const float (&planes)[6][4], const float* x, const float* y, const float* z,
+                             const float* extentX, const float* extentY, const float* extentZ,
+                             size_t start, size_t count, CONTAINMENT* out) {
+        typedef FloatPacket<W> Float;
+        typedef Vec3Packet<W> Vec3;
+
+        size_t i = start;
+        for (; i + W::WIDTH <= count; i += W::WIDTH) {
+            Vec3 center = Vec3::load(x + i, y + i, z + i);
+            Vec3 extents = Vec3::load(extentX + i, extentY + i, extentZ + i);
+            Float nearest(INF), farthest(INF);
+            for (int p = 0; p < 6; ++p) {
+                Vec3 normal(planes[p][0], planes[p][1], planes[p][2]);
+                Float dist = center.dot(normal) + Float(planes[p][3]);
+                Float r = extents.dot(abs(normal));
+                nearest = min(nearest, dist + r);
+                farthest = min(farthest, dist - r);
+            }
+
+            float n[W::WIDTH], f[W::WIDTH];
+            nearest.store(n);
+            farthest.store(f);
+            for (int j = 0; j < W::WIDTH; ++j) {
+                out[i + j] = toContainment(n[j], f[j]);
+            }
+        }
+        return i;
+    }
+
+    /*
+    min with the same NaN behaviour as SIMD::min (std::fmin is a library call on most compilers).
+    */
+    inline float minf(float a, float b) {
+        return a < b ? a : b;
+    }
+
+    /*
+    The scalar versions, with the operations in the same order as the wide kernels so results match exactly.
+    */
+    inline CONTAINMENT classifySphere(const float (&planes)[6][4], float x, float y, float z, float radius) {
+        float nearest = INF, farthest = INF;
+        for (int p = 0; p < 6; ++p) {
+            float dist = ((planes[p][0]*x + planes[p][1]*y) + planes[p][2]*z) + planes[p][3];
+            nearest = minf(nearest, dist + radius);
+            farthest = minf(farthest, dist - radius);
+        }
+        return toContainment(nearest, farthest);
+    }
+
+    inline CONTAINMENT classifyBox(const float (&planes)[6][4], float x, float y, float z,
+                                   float extentX, float extentY, float extentZ) {
+        float nearest = INF, farthest = INF;
+        for (int p = 0; p < 6; ++p) {
+            float dist = ((planes[p][0]*x + planes[p][1]*y) + planes[p][2]*z) + planes[p][3];
+            float r = (std::fabs(planes[p][0])*extentX + std::fabs(planes[p][1])*extentY)
+                    + std::fabs(planes[p][2])*extentZ;
+            nearest = minf(nearest, dist + r);
+            farthest = minf(farthest, dist - r);
+        }
+        return toContainment(nearest, farthest);
+    }
+}
+
+Frustum::Frustum() {
+    for (int p = 0; p < 6; ++p) {
+        planes[p][0] = 0.0f;
+        planes[p][1] = 0.0f;
+        planes[p][2] = 0.0f;
+        planes[p][3] = INF;
+    }
+}
+
+Frustum::Frustum(const Matrix4x4& viewProjection) {
+    // a point is inside when -w <= x, y, z <= w after the transform, so each plane is row 3 plus or minus another row
+    for (int p = 0; p < 6; ++p) {
+        int row = p / 2;
+        float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+        for (int i = 0; i < 4; ++i) {
+            planes[p][i] = viewProjection[3][i] + sign * viewProjection[row][i];
+        }
+
+        float length = std::sqrt(planes[p][0]*planes[p][0] + planes[p][1]*planes[p][1] + planes[p][2]*planes[p][2]);
+        for (int i = 0; i < 4; ++i) {
+            planes[p][i] /= length;
+        }
+    }
+}
+
+const float* Frustum::getPlane(int i) const {
+    return planes[i];
+}
+
+CONTAINMENT Frustum::classify(const Vector4& center, float radius) const {
+    return classifySphere(planes, center[0], center[1], center[2], radius);
+}
+
+CONTAINMENT Frustum::classify(const BoundingSphere& sphere) const {
+    if (sphere.isEmpty()) {
+        return CONTAINMENT::OUTSIDE;
+    }
+    return classify(sphere.getCenter(), sphere.getRadius());
+}
+
+CONTAINMENT Frustum::classify(const AABB& box) const {
+    if (box.isEmpty()) {
+        return CONTAINMENT::OUTSIDE;
+    }
+    Vector4 center = box.getCenter();
+    Vector4 extents = box.getExtents();
+    return classifyBox(planes, center[0], center[1], center[2], extents[0], extents[1], extents[2]);
+}
+
+void Frustum::classifySpheres(const float* x, const float* y, const float* z, const float* radius,
+                              size_t count, CONTAINMENT* out) const {
+    size_t i = classifySpheresWide<SIMD::Wide8>(planes, x, y, z, radius, 0, count, out);
+    i = classifySpheresWide<SIMD::Wide4>(planes, x, y, z, radius, i, count, out);
+    for (; i < count; ++i) {
+        out[i] = classifySphere(planes, x[i], y[i], z[i], radius[i]);
+    }
+}
+
+void Frustum::classifyBoxes(const float* x, const float* y, const float* z,
+                            const float* extentX, const float* extentY, const float* extentZ,
+                            size_t count, CONTAINMENT* out) const {
+    size_t i = classifyBoxesWide<SIMD::Wide8>(planes, x, y, z, extentX, extentY, extentZ, 0, count, out);
+    i = classifyBoxesWide<SIMD::Wide4>(planes, x, y, z, extentX, extentY, extentZ, i, count, out);
+    for (; i < count; ++i) {
+        out[i] = classifyBox(planes, x[i], y[i], z[i], extentX[i], extentY[i], extentZ[i]);
+    }
+}
+
+std::ostream& Math3D::operator <<(std::ostream &outs, const Frustum &frustum) {
+    for (int p = 0; p < 6; ++p) {
+        const float* plane = frustum.getPlane(p);
+        outs << (p == 0 ? "" : ", ") << plane[0] << ", " << plane[1] << ", " << plane[2] << ", " << plane[3];
+    }
+
+    return outs;
+}
@@ -0,0 +1,65 @@
+#ifndef FRUSTUM_HPP
+#define FRUSTUM_HPP
+
+#include <cstddef>
+#include <iostream>
+
+#include "math/aabb.hpp"
+#include "math/boundingsphere.hpp"
+#include "math/matrix4x4.hpp"
+#include "math/vector4.hpp"
+
+namespace Math3D {
+    enum class CONTAINMENT {
+        OUTSIDE,
+        INTERSECTING,
+        INSIDE
+    };
+
+    /*
+    A view frustum, stored as six planes (left, right, bottom, top, near, far) whose normals point inwards.
+    */
+    class Frustum {
+     public:
+        /*
+        Returns a frustum that contains everything.
+        */
+        Frustum();
+        /*
+        Returns the frustum of the matrix, which is usually projection * cameraInverse (Gribb and Hartmann's
+        method). The planes are normalized so distances to them are in world units.
+        */
+        explicit Frustum(const Matrix4x4& viewProjection);
+        /*
+        Returns the plane as a, b, c, d where a*x + b*y + c*z + d is the signed distance to it.
+        */
+        const float* getPlane(int i) const;
+        /*
+        Classifies a single volume against the frustum. Empty volumes are always outside.
+        */
+        CONTAINMENT classify(const Vector4& center, float radius) const;
+        CONTAINMENT classify(const BoundingSphere& sphere) const;
+        CONTAINMENT classify(const AABB& box) const;
+        /*
+        Classifies count spheres, given as separate arrays (structure of arrays) of center coordinates and
+        radii, writing one result per sphere to out. Eight spheres are tested per iteration, results are
+        the same as classifying each sphere on its own.
+        */
+        void classifySpheres(const float* x, const float* y, const float* z, const float* radius,
+                             std::size_t count, CONTAINMENT* out) const;
+        /*
+        Classifies count boxes, given as separate arrays of centers and extents (half sizes), writing
+        one result per box to out. Eight boxes are tested per iteration.
+        */
+        void classifyBoxes(const float* x, const float* y, const float* z,
+                           const float* extentX, const float* extentY, const float* extentZ,
+                           std::size_t count, CONTAINMENT* out) const;
+
+     private:
+        alignas(16) float planes[6][4];
+    };
+
+    std::ostream& operator <<(std::ostream &outs, const Frustum &frustum);
+}
+
+#endif
@@ -0,0 +1,381 @@
+#include "math/intersection.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include "math/packet.hpp"
+
+using std::size_t;
+using namespace Math3D;
+
+namespace {
+    const float INF = std::numeric_limits<float>::infinity();
+    // determinants smaller than this mean the ray is parallel to the triangle
+    const float DET_EPSILON = 1e-8f;
+    // 1 + 2 * gamma(3), the bound on the error of the slab distances (Ize, "Robust BVH Ray Traversal")
+    const float WATERTIGHT_SCALE = 1.0f + 2.0f * (3.0f * 0.5f * std::numeric_limits<float>::epsilon())
+                                               / (1.0f - 3.0f * 0.5f * std::numeric_limits<float>::epsilon());
+
+    /*
+    min and max with the same NaN behaviour as SIMD::min and SIMD::max, so the scalar and wide
+    kernels agree exactly.
+    */
+    inline float minf(float a, float b) {
+        return a < b ? a : b;
+    }
+
+    inline float maxf(float a, float b) {
+        return a > b ? a : b;
+    }
+
+    /*
+    The triangle kernels test one ray against one triangle (test) or W::WIDTH triangles (testWide), the wide
+    version returns a bit mask of the lanes that hit. Each is written with the operations in the same
+    order as its scalar version so the results are identical.
+    */
+    struct MollerTrumbore {
+        static bool test(const Ray& ray, const float* a, const float* b, const float* c, float tMax,
+                         float& t, float& u, float& v) {
+            const float* o = ray.getOrigin().getValues();
+            const float* d = ray.getDirection().getValues();
+
+            float e1x = b[0] - a[0], e1y = b[1] - a[1], e1z = b[2] - a[2];
+            float e2x = c[0] - a[0], e2y = c[1] - a[1], e2z = c[2] - a[2];
+
+            float px = d[1]*e2z - d[2]*e2y;
+            float py = d[2]*e2x - d[0]*e2z;
+            float pz = d[0]*e2y - d[1]*e2x;
+            float det = (e1x*px + e1y*py) + e1z*pz;
+            if (!(std::fabs(det) >= DET_EPSILON)) {
+                return false;
+            }
+            float inverseDet = 1.0f / det;
+
+            float sx = o[0] - a[0], sy = o[1] - a[1], sz = o[2] - a[2];
+            u = ((sx*px + sy*py) + sz*pz) * inverseDet;
+
+            float qx = sy*e1z - sz*e1y;
+            float qy = sz*e1x - sx*e1z;
+            float qz = sx*e1y - sy*e1x;
+            v = ((d[0]*qx + d[1]*qy) + d[2]*qz) * inverseDet;
+            t = ((e2x*qx + e2y*qy) + e2z*qz) * inverseDet;
+
+            return u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t > 0.0f && t <= tMax;
+        }
+
+        template <typename W>
+        static int testWide(const Ray& ray, const float* const* coords, size_t i, float tMax,
+                            float* t, float* u, float* v) {
+            typedef FloatPacket<W> Float;
+            typedef Vec3Packet<W> Vec3;
+
+            Vec3 a = Vec3::load(coords[0] + i, coords[1] + i, coords[2] + i);
+            Vec3 e1 = Vec3::load(coords[3] + i, coords[4] + i, coords[5] + i) - a;
+            Vec3 e2 = Vec3::load(coords[6] + i, coords[7] + i, coords[8] + i) - a;
+            Vec3 d(ray.getDirection());
+
+            Vec3 p = d.cross(e2);
+            Float det = e1.dot(p);
+            Float inverseDet = Float(1.0f) / det;
+
+            Vec3 s = Vec3(ray.getOrigin()) - a;
+            Float uu = s.dot(p) * inverseDet;
+
+            Vec3 q = s.cross(e1);
+            Float vv = d.dot(q) * inverseDet;
+            Float tt = e2.dot(q) * inverseDet;
+
+            MaskPacket<W> hit = abs(det) >= Float(DET_EPSILON);
+            hit = hit & (uu >= Float(0.0f)) & (vv >= Float(0.0f)) & (uu + vv <= Float(1.0f));
+            hit = hit & (tt > Float(0.0f)) & (tt <= Float(tMax));
+
+            tt.store(t);
+            uu.store(u);
+            vv.store(v);
+            return hit.bits();
+        }
+    };
+
+    struct Watertight {
+        static bool test(const Ray& ray, const float* a, const float* b, const float* c, float tMax,
+                         float& t, float& u, float& v) {
+            const float* o = ray.getOrigin().getValues();
+            const float* shear = ray.getShear().getValues();
+            int kx = ray.getShearAxis(0), ky = ray.getShearAxis(1), kz = ray.getShearAxis(2);
+
+            // move the triangle into a space where the ray starts at the origin and points down +z
+            float az = a[kz] - o[kz], bz = b[kz] - o[kz], cz = c[kz] - o[kz];
+            float ax = (a[kx] - o[kx]) - shear[0]*az, ay = (a[ky] - o[ky]) - shear[1]*az;
+            float bx = (b[kx] - o[kx]) - shear[0]*bz, by = (b[ky] - o[ky]) - shear[1]*bz;
+            float cx = (c[kx] - o[kx]) - shear[0]*cz, cy = (c[ky] - o[ky]) - shear[1]*cz;
+
+            // scaled barycentric coordinates, the ray hits when they all have the same sign
+            float U = cx*by - cy*bx;
+            float V = ax*cy - ay*cx;
+            float W = bx*ay - by*ax;
+            if (!((U >= 0.0f && V >= 0.0f && W >= 0.0f) || (U <= 0.0f && V <= 0.0f && W <= 0.0f))) {
+                return false;
+            }
+            float det = (U + V) + W;
+            if (!(std::fabs(det) > 0.0f)) {
+                return false;
+            }
+            float inverseDet = 1.0f / det;
+
+            float T = (U*(shear[2]*az) + V*(shear[2]*bz)) + W*(shear[2]*cz);
+            t = T * inverseDet;
+            u = V * inverseDet;
+            v = W * inverseDet;
+
+            return t > 0.0f && t <= tMax;
+        }
+
+        template <typename W>
+        static int testWide(const Ray& ray, const float* const* coords, size_t i, float tMax,
+                            float* t, float* u, float* v) {
+            typedef FloatPacket<W> Float;
+            const float* o = ray.getOrigin().getValues();
+            const float* shear = ray.getShear().getValues();
+            int kx = ray.getShearAxis(0), ky = ray.getShearAxis(1), kz = ray.getShearAxis(2);
+
+            Float ox(o[kx]), oy(o[ky]), oz(o[kz]);
+            Float sx(shear[0]), sy(shear[1]), sz(shear[2]);
+
+            Float az = Float::load(coords[kz] + i) - oz;
+            Float bz = Float::load(coords[3 + kz] + i) - oz;
+            Float cz = Float::load(coords[6 + kz] + i) - oz;
+            Float ax = (Float::load(coords[kx] + i) - ox) - sx*az;
+            Float ay = (Float::load(coords[ky] + i) - oy) - sy*az;
+            Float bx = (Float::load(coords[3 + kx] + i) - ox) - sx*bz;
+            Float by = (Float::load(coords[3 + ky] + i) - oy) - sy*bz;
+            Float cx = (Float::load(coords[6 + kx] + i) - ox) - sx*cz;
+            Float cy = (Float::load(coords[6 + ky] + i) - oy) - sy*cz;
+
+            Float U = cx*by - cy*bx;
+            Float V = ax*cy - ay*cx;
+            Float Wb = bx*ay - by*ax;
+
+            Float zero(0.0f);
+            MaskPacket<W> positive = (U >= zero) & (V >= zero) & (Wb >= zero);
+            MaskPacket<W> negative = (U <= zero) & (V <= zero) & (Wb <= zero);
+            Float det = (U + V) + Wb;
+            Float inverseDet = Float(1.0f) / det;
+
+            Float T = (U*(sz*az) + V*(sz*bz)) + Wb*(sz*cz);
+            Float tt = T * inverseDet;
+
+            MaskPacket<W> hit = (positive | negative) & (abs(det) > zero);
+            hit = hit & (tt > zero) & (tt <= Float(tMax));
+
+            tt.store(t);
+            (V * inverseDet).store(u);
+            (Wb * inverseDet).store(v);
+            return hit.bits();
+        }
+    };
+
+    /*
+    Tests triangles from index i in blocks of W::WIDTH, keeping the closest hit. Returns the index of the first
+    triangle not tested.
+    */
+    template <typename K, typename W>
+    size_t closestHitWide(const Ray& ray, const float* const* coords, size_t i, size_t count, float tMax,
+                          bool& found, RayHit& hit) {
+        float t[W::WIDTH], u[W::WIDTH], v[W::WIDTH];
+        for (; i + W::WIDTH <= count; i += W::WIDTH) {
+            int mask = K::template testWide<W>(ray, coords, i, found ? hit.t : tMax, t, u, v);
+            for (int j = 0; mask != 0; ++j, mask >>= 1) {
+                if ((mask & 1) && (!found || t[j] < hit.t)) {
+                    found = true;
+                    hit.t = t[j];
+                    hit.u = u[j];
+                    hit.v = v[j];
+                    hit.index = static_cast<int>(i + j);
+                }
+            }
+        }
+        return i;
+    }
+
+    template <typename K>
+    bool closestHit(const Ray& ray, const std::vector<float> (&coords)[9], float tMax, RayHit& hit) {
+        const float* p[9];
+        for (int k = 0; k < 9; ++k) {
+            p[k] = coords[k].data();
+        }
+        size_t count = coords[0].size();
+
+        bool found = false;
+        size_t i = closestHitWide<K, SIMD::Wide8>(ray, p, 0, count, tMax, found, hit);
+        i = closestHitWide<K, SIMD::Wide4>(ray, p, i, count, tMax, found, hit);
+        for (; i < count; ++i) {
+            float a[3] = {p[0][i], p[1][i], p[2][i]};
+            float b[3] = {p[3][i], p[4][i], p[5][i]};
+            float c[3] = {p[6][i], p[7][i], p[8][i]};
+            float t, u, v;
+            if (K::test(ray, a, b, c, found ? hit.t : tMax, t, u, v) && (!found || t < hit.t)) {
+                found = true;
+                hit.t = t;
+                hit.u = u;
+                hit.v = v;
+                hit.index = static_cast<int>(i);
+            }
+        }
+        return found;
+    }
+
+    /*
+    The slab test for one box, scale is applied to the exit distance (1 for the plain test).
+    */
+    inline bool slab(const Ray& ray, const float* min, const float* max, float tMax, float scale, float& tNear) {
+        const float* o = ray.getOrigin().getValues();
+        const float* inv = ray.getInverseDirection().getValues();
+
+        float t1x = (min[0] - o[0]) * inv[0], t2x = (max[0] - o[0]) * inv[0];
+        float t1y = (min[1] - o[1]) * inv[1], t2y = (max[1] - o[1]) * inv[1];
+        float t1z = (min[2] - o[2]) * inv[2], t2z = (max[2] - o[2]) * inv[2];
+
+        float enter = maxf(maxf(maxf(minf(t1x, t2x), minf(t1y, t2y)), minf(t1z, t2z)), 0.0f);
+        float exit = minf(minf(minf(maxf(t1x, t2x), maxf(t1y, t2y)), maxf(t1z, t2z)) * scale, tMax);
+
+        tNear = enter;
+        return enter <= exit;
+    }
+
+    template <typename W>
+    size_t slabWide(const Ray& ray, const float* const* coords, size_t i, size_t count, float tMax, float scale,
+                    float* tNear, size_t& hits) {
+        typedef FloatPacket<W> Float;
+        typedef Vec3Packet<W> Vec3;
+
+        Vec3 o(ray.getOrigin());
+        Vec3 inv(ray.getInverseDirection());
+
+        for (; i + W::WIDTH <= count; i += W::WIDTH) {
+            Vec3 boxMin = Vec3::load(coords[0] + i, coords[1] + i, coords[2] + i);
+            Vec3 boxMax = Vec3::load(coords[3] + i, coords[4] + i, coords[5] + i);
+            Vec3 t1 = (boxMin - o) * inv;
+            Vec3 t2 = (boxMax - o) * inv;
+            Vec3 lo = min(t1, t2), hi = max(t1, t2);
+
+            Float enter = max(max(max(lo.x, lo.y), lo.z), Float(0.0f));
+            Float exit = min(min(min(hi.x, hi.y), hi.z) * Float(scale), Float(tMax));
+
+            // empty boxes are stored inverted along x, see BoxBatch::add
+            MaskPacket<W> hit = (enter <= exit) & (boxMin.x <= boxMax.x);
+            select(hit, enter, Float(INF)).store(tNear + i);
+            for (int mask = hit.bits(); mask != 0; mask &= mask - 1) {
+                ++hits;
+            }
+        }
+        return i;
+    }
+
+    size_t slabBatch(const Ray& ray, const std::vector<float> (&coords)[6], float tMax, float scale, float* tNear) {
+        const float* p[6];
+        for (int k = 0; k < 6; ++k) {
+            p[k] = coords[k].data();
+        }
+        size_t count = coords[0].size();
+
+        size_t hits = 0;
+        size_t i = slabWide<SIMD::Wide8>(ray, p, 0, count, tMax, scale, tNear, hits);
+        i = slabWide<SIMD::Wide4>(ray, p, i, count, tMax, scale, tNear, hits);
+        for (; i < count; ++i) {
+            float min[3] = {p[0][i], p[1][i], p[2][i]};
+            float max[3] = {p[3][i], p[4][i], p[5][i]};
+            if (min[0] <= max[0] && slab(ray, min, max, tMax, scale, tNear[i])) {
+                ++hits;
+            } else {
+                tNear[i] = INF;
+            }
+        }
+        return hits;
+    }
+
+    template <typename K>
+    bool intersectTriangle(const Ray& ray, const Vector4& a, const Vector4& b, const Vector4& c, float tMax,
+                           RayHit& hit) {
+        float t, u, v;
+        if (!K::test(ray, a.getValues(), b.getValues(), c.getValues(), tMax, t, u, v)) {
+            return false;
+        }
+        hit.t = t;
+        hit.u = u;
+        hit.v = v;
+        return true;
+    }
+}
+
+bool Math3D::intersect(const Ray& ray, const Vector4& a, const Vector4& b, const Vector4& c, float tMax,
+                       RayHit& hit) {
+    return intersectTriangle<MollerTrumbore>(ray, a, b, c, tMax, hit);
+}
+
+bool Math3D::intersectWatertight(const Ray& ray, const Vector4& a, const Vector4& b, const Vector4& c, float tMax,
+                                 RayHit& hit) {
+    return intersectTriangle<Watertight>(ray, a, b, c, tMax, hit);
+}
+
+bool Math3D::intersect(const Ray& ray, const AABB& box, float tMax, float& tNear) {
+    return !box.isEmpty() && slab(ray, box.getMin().getValues(), box.getMax().getValues(), tMax, 1.0f, tNear);
+}
+
+bool Math3D::intersectWatertight(const Ray& ray, const AABB& box, float tMax, float& tNear) {
+    return !box.isEmpty()
+        && slab(ray, box.getMin().getValues(), box.getMax().getValues(), tMax, WATERTIGHT_SCALE, tNear);
+}
+
+void TriangleBatch::add(const Vector4& a, const Vector4& b, const Vector4& c) {
+    for (int k = 0; k < 3; ++k) {
+        coords[k].push_back(a[k]);
+        coords[3 + k].push_back(b[k]);
+        coords[6 + k].push_back(c[k]);
+    }
+}
+
+void TriangleBatch::clear() {
+    for (int k = 0; k < 9; ++k) {
+        coords[k].clear();
+    }
+}
+
+size_t TriangleBatch::size() const {
+    return coords[0].size();
+}
+
+bool TriangleBatch::intersect(const Ray& ray, float tMax, RayHit& hit) const {
+    return closestHit<MollerTrumbore>(ray, coords, tMax, hit);
+}
+
+bool TriangleBatch::intersectWatertight(const Ray& ray, float tMax, RayHit& hit) const {
+    return closestHit<Watertight>(ray, coords, tMax, hit);
+}
+
+void BoxBatch::add(const AABB& box) {
+    // the slab test hits a box inverted along an axis as if it were the right way round, so the batch masks
+    // out boxes inverted along x and stores every empty box inverted along x
+    bool empty = box.isEmpty();
+    for (int k = 0; k < 3; ++k) {
+        coords[k].push_back(empty ? INF : box.getMin()[k]);
+        coords[3 + k].push_back(empty ? -INF : box.getMax()[k]);
+    }
+}
+
+void BoxBatch::clear() {
+    for (int k = 0; k < 6; ++k) {
+        coords[k].clear();
+    }
+}
+
+size_t BoxBatch::size() const {
+    return coords[0].size();
+}
+
+size_t BoxBatch::intersect(const Ray& ray, float tMax, float* tNear) const {
+    return slabBatch(ray, coords, tMax, 1.0f, tNear);
+}
+
+size_t BoxBatch::intersectWatertight(const Ray& ray, float tMax, float* tNear) const {
+    return slabBatch(ray, coords, tMax, WATERTIGHT_SCALE, tNear);
+}
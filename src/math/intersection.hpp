@@ -0,0 +1,88 @@
+#ifndef INTERSECTION_HPP
+#define INTERSECTION_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "math/aabb.hpp"
+#include "math/ray.hpp"
+#include "math/vector4.hpp"
+
+namespace Math3D {
+    /*
+    Where a ray hit a triangle. t is the distance along the ray, u and v are the barycentric weights of the
+    triangle's second and third vertices, and index is the triangle's index when testing a batch.
+    */
+    struct RayHit {
+        float t;
+        float u;
+        float v;
+        int index;
+
+        RayHit() : t(0.0f), u(0.0f), v(0.0f), index(-1) {}
+    };
+
+    /*
+    Returns whether the ray hits the triangle at a distance in (0, tMax], filling in hit if so (Moller and Trumbore).
+    Both sides of the triangle are hit.
+    */
+    bool intersect(const Ray& ray, const Vector4& a, const Vector4& b, const Vector4& c, float tMax, RayHit& hit);
+    /*
+    As above, but watertight (Woop, Benthin and Wald): a ray through an edge or vertex shared by
+    triangles always hits at least one of them. It is somewhat slower.
+    */
+    bool intersectWatertight(const Ray& ray, const Vector4& a, const Vector4& b, const Vector4& c, float tMax,
+                             RayHit& hit);
+    /*
+    Returns whether the ray hits the box at a distance in [0, tMax], setting tNear to where it enters the box
+    (0 if the origin is inside it). Uses the slab method.
+    */
+    bool intersect(const Ray& ray, const AABB& box, float tMax, float& tNear);
+    /*
+    As above, but the exit distance is rounded up so that floating point error never makes the ray
+    miss a box it touches (Ize, "Robust BVH Ray Traversal").
+    */
+    bool intersectWatertight(const Ray& ray, const AABB& box, float tMax, float& tNear);
+
+    /*
+    Triangles stored as structure of arrays, so one ray can be tested against eight triangles per iteration.
+    */
+    class TriangleBatch {
+     public:
+        void add(const Vector4& a, const Vector4& b, const Vector4& c);
+        void clear();
+        std::size_t size() const;
+        /*
+        Finds the closest triangle hit by the ray within (0, tMax], with the same results as testing
+        each triangle on its own. Ties go to the lowest index.
+        */
+        bool intersect(const Ray& ray, float tMax, RayHit& hit) const;
+        bool intersectWatertight(const Ray& ray, float tMax, RayHit& hit) const;
+
+     private:
+        // x, y and z of the first vertex, then the second, then the third
+        std::vector<float> coords[9];
+    };
+
+    /*
+    Boxes stored as structure of arrays, so one ray can be tested against eight boxes per iteration.
+    */
+    class BoxBatch {
+     public:
+        void add(const AABB& box);
+        void clear();
+        std::size_t size() const;
+        /*
+        Writes the entry distance of the ray into each box to tNear, or infinity where it misses,
+        and returns the number of boxes hit. Empty boxes are never hit.
+        */
+        std::size_t intersect(const Ray& ray, float tMax, float* tNear) const;
+        std::size_t intersectWatertight(const Ray& ray, float tMax, float* tNear) const;
+
+     private:
+        // x, y and z of the minimum corner, then the maximum corner
+        std::vector<float> coords[6];
+    };
+}
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef MAT_HPP
+#define MAT_HPP
+
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+
+#include "math/vec.hpp"
+
+namespace Math3D {
+    /*
+    A tightly packed R x C matrix of type T, stored row-major as R rows of Vec<C, T>.
+    */
+    template <std::size_t R, std::size_t C, typename T>
+    class Mat {
+        typedef typename Detail::MakeIndices<R>::type RowIndices;
+        typedef typename Detail::MakeIndices<C>::type ColumnIndices;
+
+     public:
+        /*
+        Returns matrix with every value set to zero.
+        */
+        constexpr Mat() : rows() {}
+        /*
+        Returns matrix from exactly R rows, like Mat<2, 2, float>(Vec2f(1, 0), Vec2f(0, 1)).
+        */
+        template <typename... Rows, typename = typename std::enable_if<sizeof...(Rows) == R>::type>
+        constexpr Mat(const Rows&... r) : rows{r...} {}
+        /*
+        Returns identity matrix (ones on the diagonal).
+        */
+        static constexpr Mat identity() {
+            return identity(RowIndices());
+        }
+        /*
+        Returns the given column of the matrix.
+        */
+        constexpr Vec<R, T> column(std::size_t c) const {
+            return column(c, RowIndices());
+        }
+        /*
+        Returns the matrix transposed.
+        */
+        constexpr Mat<C, R, T> transpose() const {
+            return transpose(ColumnIndices());
+        }
+        /*
+        Returns the vector that results from this matrix being multiplied by a vector.
+        */
+        constexpr Vec<R, T> operator*(const Vec<C, T>& b) const {
+            return multiply(b, RowIndices());
+        }
+        /*
+        Returns the matrix that results from this matrix being multiplied by another.
+        */
+        template <std::size_t K>
+        constexpr Mat<R, K, T> operator*(const Mat<C, K, T>& b) const {
+            return multiply(b.transpose(), RowIndices());
+        }
+
+        /*
+        Compares the rows as Vec does, each value to within EPSILON.
+        */
+        constexpr bool operator==(const Mat& b) const { return equal(b, 0); }
+        constexpr bool operator!=(const Mat& b) const { return !equal(b, 0); }
+        /*
+        Allows the matrix's values to be indexed like Mat[row][column]
+        */
+        Vec<C, T>& operator[](std::size_t row) { return rows[row]; }
+        constexpr const Vec<C, T>& operator[](std::size_t row) const { return rows[row]; }
+        /*
+        Returns pointer to the matrix's value array
+        */
+        T* getValues() { return rows[0].getValues(); }
+        const T* getValues() const { return rows[0].getValues(); }
+
+     private:
+        Vec<C, T> rows[R];
+
+        template <std::size_t... I>
+        static constexpr Vec<C, T> unitRow(std::size_t row, Detail::Indices<I...>) {
+            return Vec<C, T>((I == row ? T(1) : T(0))...);
+        }
+        template <std::size_t... I>
+        static constexpr Mat identity(Detail::Indices<I...>) {
+            return Mat(unitRow(I, ColumnIndices())...);
+        }
+        template <std::size_t... I>
+        constexpr Vec<R, T> column(std::size_t c, Detail::Indices<I...>) const {
+            return Vec<R, T>(rows[I][c]...);
+        }
+        template <std::size_t... I>
+        constexpr Mat<C, R, T> transpose(Detail::Indices<I...>) const {
+            return Mat<C, R, T>(column(I)...);
+        }
+        template <std::size_t... I>
+        constexpr Vec<R, T> multiply(const Vec<C, T>& b, Detail::Indices<I...>) const {
+            return Vec<R, T>(rows[I].dot(b)...);
+        }
+        // bTransposed's rows are b's columns, so each output row is bTransposed * row
+        template <std::size_t K, std::size_t... I>
+        constexpr Mat<R, K, T> multiply(const Mat<K, C, T>& bTransposed, Detail::Indices<I...>) const {
+            return Mat<R, K, T>((bTransposed * rows[I])...);
+        }
+        constexpr bool equal(const Mat& b, std::size_t i) const {
+            return i == R || (rows[i] == b.rows[i] && equal(b, i + 1));
+        }
+    };
+
+    template <std::size_t R, std::size_t C, typename T>
+    std::ostream& operator <<(std::ostream &outs, const Mat<R, C, T> &mat) {
+        for (std::size_t row = 0; row < R; ++row) {
+            outs << mat[row];
+            if (row < R - 1) {
+                outs << ", ";
+            }
+        }
+        return outs;
+    }
+
+    typedef Mat<3, 3, float> Mat3f;
+    typedef Mat<3, 4, float> Mat3x4f;
+    typedef Mat<4, 4, float> Mat4f;
+}
+
+#endif
@@ -3,8 +3,21 @@
 
 #include <cmath>
 
+#include "math/aabb.hpp"
+#include "math/affinetransform.hpp"
+#include "math/batch.hpp"
+#include "math/boundingsphere.hpp"
 #include "math/constants.hpp"
+#include "math/frustum.hpp"
+#include "math/intersection.hpp"
+#include "math/mat.hpp"
 #include "math/matrix4x4.hpp"
+#include "math/obb.hpp"
+#include "math/packet.hpp"
+#include "math/quaternion.hpp"
+#include "math/ray.hpp"
+#include "math/rigidtransform.hpp"
+#include "math/vec.hpp"
 #include "math/vector4.hpp"
 
 #endif
\ No newline at end of file
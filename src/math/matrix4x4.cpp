@@ -84,6 +84,26 @@ Matrix4x4::Matrix4x4(float x, float y, float z, float r00, float r01, float r02,
     values[3][3] = 1.0f;
 }
 
+Matrix4x4::Matrix4x4(const Mat4f& mat) {
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 4; column++) {
+            values[row][column] = mat[row][column];
+        }
+    }
+}
+
+Mat4f Matrix4x4::toMat() const {
+    Mat4f out;
+
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 4; column++) {
+            out[row][column] = values[row][column];
+        }
+    }
+
+    return out;
+}
+
 Matrix4x4 Matrix4x4::fromEuler(float x, float y, float z) {
     Matrix4x4 out;
 
@@ -138,22 +158,36 @@ Matrix4x4 Matrix4x4::inverse() const {
                 + values[0][2] * values[1][0] * values[2][1] - values[0][0] * values[1][2] * values[2][1]
                 - values[0][1] * values[1][0] * values[2][2] + values[0][0] * values[1][1] * values[2][2];
     float k = 1/det;
-            
-    Matrix4x4 out;
 
-    out.values[0][0] = (values[1][1] * values[2][2] - values[2][1] * values[1][2]) * k;
-    out.values[0][1] = (values[2][1] * values[0][2] - values[0][1] * values[2][2]) * k;
-    out.values[0][2] = (values[0][1] * values[1][2] - values[1][1] * values[0][2]) * k;
-    out.values[1][0] = (values[1][2] * values[2][0] - values[2][2] * values[1][0]) * k;
-    out.values[1][1] = (values[2][2] * values[0][0] - values[0][2] * values[2][0]) * k;
-    out.values[1][2] = (values[0][2] * values[1][0] - values[1][2] * values[0][0]) * k;
-    out.values[2][0] = (values[1][0] * values[2][1] - values[2][0] * values[1][1]) * k;
-    out.values[2][1] = (values[2][0] * values[0][1] - values[0][0] * values[2][1]) * k;
-    out.values[2][2] = (values[0][0] * values[1][1] - values[1][0] * values[0][1]) * k;
+    Matrix4x4 out;
 
-    out.values[0][3] = -(out.values[0][0] * values[0][3] + out.values[0][1] * values[1][3] + out.values[0][2] * values[2][3]);
-    out.values[1][3] = -(out.values[1][0] * values[0][3] + out.values[1][1] * values[1][3] + out.values[1][2] * values[2][3]);
-    out.values[2][3] = -(out.values[2][0] * values[0][3] + out.values[2][1] * values[1][3] + out.values[2][2] * values[2][3]);
+    // the rows of the inverted rotation are the cross products of the columns, so get the columns first
+    SIMD::float4 c0 = SIMD::load(values[0]);
+    SIMD::float4 c1 = SIMD::load(values[1]);
+    SIMD::float4 c2 = SIMD::load(values[2]);
+    SIMD::float4 c3 = SIMD::load(values[3]);
+    SIMD::transpose(c0, c1, c2, c3);
+
+    SIMD::float4 scale = SIMD::splat(k);
+    SIMD::float4 r0 = SIMD::mul(SIMD::cross3(c1, c2), scale);
+    SIMD::float4 r1 = SIMD::mul(SIMD::cross3(c2, c0), scale);
+    SIMD::float4 r2 = SIMD::mul(SIMD::cross3(c0, c1), scale);
+    SIMD::store(out.values[0], r0);
+    SIMD::store(out.values[1], r1);
+    SIMD::store(out.values[2], r2);
+
+    // translation is the negated inverse rotation applied to the original translation
+    SIMD::float4 r3 = SIMD::splat(0.0f);
+    SIMD::transpose(r0, r1, r2, r3);
+    alignas(16) float translation[4];
+    SIMD::float4 t = SIMD::mul(r0, SIMD::splat(values[0][3]));
+    t = SIMD::add(t, SIMD::mul(r1, SIMD::splat(values[1][3])));
+    t = SIMD::add(t, SIMD::mul(r2, SIMD::splat(values[2][3])));
+    SIMD::store(translation, SIMD::mul(t, SIMD::splat(-1.0f)));
+
+    out.values[0][3] = translation[0];
+    out.values[1][3] = translation[1];
+    out.values[2][3] = translation[2];
 
     out.values[3][0] = values[3][0];
     out.values[3][1] = values[3][1];
@@ -163,18 +197,6 @@ Matrix4x4 Matrix4x4::inverse() const {
     return out;
 }
 
-Matrix4x4 Matrix4x4::transpose() const {
-    Matrix4x4 out;
-
-    for (int row = 0; row < 4; row++) {
-        for (int column = 0; column < 4; column++) {
-            out.values[column][row] = values[row][column];
-        }
-    }
-
-    return out;
-}
-
 Vector4 Matrix4x4::lookvector() const {
     Vector4 out;
 
@@ -186,56 +208,10 @@ Vector4 Matrix4x4::lookvector() const {
     return out;
 }
 
-Vector4 Matrix4x4::position() const {
-    Vector4 out;
-
-    out[0] = values[0][3];
-    out[1] = values[1][3];
-    out[2] = values[2][3];
-    out[3] = 1.0f;
-
-    return out;
-}
-
 Matrix4x4 Matrix4x4::rotation() const {
     return operator-(position());
 }
 
-Matrix4x4 Matrix4x4::operator*(const Matrix4x4& b) const {
-    Matrix4x4 out;
-
-    // using b.values because it is more efficient and we have access to private member variables
-    out.values[0][0] = values[0][0] * b.values[0][0] + values[0][1] * b.values[1][0] + values[0][2] * b.values[2][0] + values[0][3] * b.values[3][0];
-    out.values[0][1] = values[0][0] * b.values[0][1] + values[0][1] * b.values[1][1] + values[0][2] * b.values[2][1] + values[0][3] * b.values[3][1];
-    out.values[0][2] = values[0][0] * b.values[0][2] + values[0][1] * b.values[1][2] + values[0][2] * b.values[2][2] + values[0][3] * b.values[3][2];
-    out.values[0][3] = values[0][0] * b.values[0][3] + values[0][1] * b.values[1][3] + values[0][2] * b.values[2][3] + values[0][3] * b.values[3][3];
-    out.values[1][0] = values[1][0] * b.values[0][0] + values[1][1] * b.values[1][0] + values[1][2] * b.values[2][0] + values[1][3] * b.values[3][0];
-    out.values[1][1] = values[1][0] * b.values[0][1] + values[1][1] * b.values[1][1] + values[1][2] * b.values[2][1] + values[1][3] * b.values[3][1];
-    out.values[1][2] = values[1][0] * b.values[0][2] + values[1][1] * b.values[1][2] + values[1][2] * b.values[2][2] + values[1][3] * b.values[3][2];
-    out.values[1][3] = values[1][0] * b.values[0][3] + values[1][1] * b.values[1][3] + values[1][2] * b.values[2][3] + values[1][3] * b.values[3][3];
-    out.values[2][0] = values[2][0] * b.values[0][0] + values[2][1] * b.values[1][0] + values[2][2] * b.values[2][0] + values[2][3] * b.values[3][0];
-    out.values[2][1] = values[2][0] * b.values[0][1] + values[2][1] * b.values[1][1] + values[2][2] * b.values[2][1] + values[2][3] * b.values[3][1];
-    out.values[2][2] = values[2][0] * b.values[0][2] + values[2][1] * b.values[1][2] + values[2][2] * b.values[2][2] + values[2][3] * b.values[3][2];
-    out.values[2][3] = values[2][0] * b.values[0][3] + values[2][1] * b.values[1][3] + values[2][2] * b.values[2][3] + values[2][3] * b.values[3][3];
-    out.values[3][0] = values[3][0] * b.values[0][0] + values[3][1] * b.values[1][0] + values[3][2] * b.values[2][0] + values[3][3] * b.values[3][0];
-    out.values[3][1] = values[3][0] * b.values[0][1] + values[3][1] * b.values[1][1] + values[3][2] * b.values[2][1] + values[3][3] * b.values[3][1];
-    out.values[3][2] = values[3][0] * b.values[0][2] + values[3][1] * b.values[1][2] + values[3][2] * b.values[2][2] + values[3][3] * b.values[3][2];
-    out.values[3][3] = values[3][0] * b.values[0][3] + values[3][1] * b.values[1][3] + values[3][2] * b.values[2][3] + values[3][3] * b.values[3][3];
-
-    return out;
-}
-
-Vector4 Matrix4x4::operator*(const Vector4& b) const {
-    Vector4 out;
-
-    out[0] = values[0][0] * b[0] + values[0][1] * b[1] + values[0][2] * b[2] + values[0][3] * b[3];
-    out[1] = values[1][0] * b[0] + values[1][1] * b[1] + values[1][2] * b[2] + values[1][3] * b[3];
-    out[2] = values[2][0] * b[0] + values[2][1] * b[1] + values[2][2] * b[2] + values[2][3] * b[3];
-    out[3] = values[3][0] * b[0] + values[3][1] * b[1] + values[3][2] * b[2] + values[3][3] * b[3];
-
-    return out;
-}
-
 Matrix4x4 Matrix4x4::operator+(const Vector4& b) const {
     Matrix4x4 out;
 
@@ -304,31 +280,6 @@ bool Matrix4x4::operator!=(const Matrix4x4& b) const {
     return false;
 }
 
-Matrix4x4& Matrix4x4::operator=(const Matrix4x4& b) {
-    for (int row = 0; row < 4; row++) {
-        for (int column = 0; column < 4; column++) {
-            values[row][column] = b.values[row][column];
-        }
-    }
-    return *this;
-}
-
-float* Matrix4x4::operator[](int row) {
-    return values[row];
-}
-
-const float* Matrix4x4::operator[](int row) const {
-    return values[row];
-}
-
-float* Matrix4x4::getValues() {
-    return *values;
-}
-
-const float* Matrix4x4::getValues() const {
-    return *values;
-}
-
 std::ostream& Math3D::operator <<(std::ostream &outs, const Matrix4x4 &mat) {
     for (int row = 0; row < 4; row++) {
         for (int column = 0; column < 4; column++) {
@@ -3,6 +3,8 @@
 
 #include <iostream>
 
+#include "math/mat.hpp"
+#include "math/simd.hpp"
 #include "math/vector4.hpp"
 
 namespace Math3D {
@@ -25,6 +27,14 @@ namespace Math3D {
         */
         Matrix4x4(float x, float y, float z, float r00, float r01, float r02, float r10, float r11, float r12, float r20, float r21, float r22);
         /*
+        Returns matrix with the values of the packed matrix.
+        */
+        explicit Matrix4x4(const Mat4f& mat);
+        /*
+        Returns the values of the matrix as a packed matrix.
+        */
+        Mat4f toMat() const;
+        /*
         Returns matrix with rotation converted from the x, y, and z euler angles.
         */
         static Matrix4x4 fromEuler(float x, float y, float z);
@@ -33,7 +43,7 @@ namespace Math3D {
         */
         static Matrix4x4 projection(float fov, float aspectRatio, float near, float far);
         /*
-        Returns the inverse of the matrix.
+        Returns the inverse of the matrix. The matrix is assumed to be affine (bottom row of 0, 0, 0, 1).
         */
         Matrix4x4 inverse() const;
         /*
@@ -86,10 +96,91 @@ namespace Math3D {
         const float* getValues() const;
 
      private:
-        float values[4][4];
+        alignas(16) float values[4][4];
     };
 
     std::ostream& operator <<(std::ostream &outs, const Matrix4x4 &mat);
+
+    // The products below are defined inline so that callers in other translation units can inline them
+
+    inline Matrix4x4 Matrix4x4::transpose() const {
+        Matrix4x4 out;
+
+        SIMD::float4 r0 = SIMD::load(values[0]);
+        SIMD::float4 r1 = SIMD::load(values[1]);
+        SIMD::float4 r2 = SIMD::load(values[2]);
+        SIMD::float4 r3 = SIMD::load(values[3]);
+        SIMD::transpose(r0, r1, r2, r3);
+        SIMD::store(out.values[0], r0);
+        SIMD::store(out.values[1], r1);
+        SIMD::store(out.values[2], r2);
+        SIMD::store(out.values[3], r3);
+
+        return out;
+    }
+
+    inline Vector4 Matrix4x4::position() const {
+        return Vector4(values[0][3], values[1][3], values[2][3]);
+    }
+
+    inline Matrix4x4 Matrix4x4::operator*(const Matrix4x4& b) const {
+        Matrix4x4 out;
+
+        SIMD::float4 b0 = SIMD::load(b.values[0]);
+        SIMD::float4 b1 = SIMD::load(b.values[1]);
+        SIMD::float4 b2 = SIMD::load(b.values[2]);
+        SIMD::float4 b3 = SIMD::load(b.values[3]);
+
+        // each output row is a linear combination of b's rows, summed in the same order as the scalar product
+        for (int row = 0; row < 4; ++row) {
+            SIMD::float4 sum = SIMD::mul(SIMD::splat(values[row][0]), b0);
+            sum = SIMD::add(sum, SIMD::mul(SIMD::splat(values[row][1]), b1));
+            sum = SIMD::add(sum, SIMD::mul(SIMD::splat(values[row][2]), b2));
+            sum = SIMD::add(sum, SIMD::mul(SIMD::splat(values[row][3]), b3));
+            SIMD::store(out.values[row], sum);
+        }
+
+        return out;
+    }
+
+    inline Vector4 Matrix4x4::operator*(const Vector4& b) const {
+        Vector4 out;
+
+        SIMD::float4 vec = SIMD::load(b.getValues());
+        SIMD::float4 p0 = SIMD::mul(SIMD::load(values[0]), vec);
+        SIMD::float4 p1 = SIMD::mul(SIMD::load(values[1]), vec);
+        SIMD::float4 p2 = SIMD::mul(SIMD::load(values[2]), vec);
+        SIMD::float4 p3 = SIMD::mul(SIMD::load(values[3]), vec);
+        // transposing the products lets all four row sums be done at once
+        SIMD::transpose(p0, p1, p2, p3);
+        SIMD::store(out.getValues(), SIMD::add(SIMD::add(SIMD::add(p0, p1), p2), p3));
+
+        return out;
+    }
+
+    inline Matrix4x4& Matrix4x4::operator=(const Matrix4x4& b) {
+        SIMD::store(values[0], SIMD::load(b.values[0]));
+        SIMD::store(values[1], SIMD::load(b.values[1]));
+        SIMD::store(values[2], SIMD::load(b.values[2]));
+        SIMD::store(values[3], SIMD::load(b.values[3]));
+        return *this;
+    }
+
+    inline float* Matrix4x4::operator[](int row) {
+        return values[row];
+    }
+
+    inline const float* Matrix4x4::operator[](int row) const {
+        return values[row];
+    }
+
+    inline float* Matrix4x4::getValues() {
+        return *values;
+    }
+
+    inline const float* Matrix4x4::getValues() const {
+        return *values;
+    }
 }
 
 #endif
\ No newline at end of file
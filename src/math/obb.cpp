@@ -0,0 +1,133 @@
+#include "math/obb.hpp"
+
+#include <cmath>
+
+using namespace Math3D;
+
+namespace {
+    // added to the cross product terms so near-parallel edges do not give false separations
+    const float SAT_EPSILON = 1e-6f;
+}
+
+OBB::OBB() : center(), extents(0.0f, 0.0f, 0.0f) {
+    axes[0] = Vector4(1.0f, 0.0f, 0.0f);
+    axes[1] = Vector4(0.0f, 1.0f, 0.0f);
+    axes[2] = Vector4(0.0f, 0.0f, 1.0f);
+}
+
+OBB::OBB(const Vector4& c, const Vector4& xAxis, const Vector4& yAxis, const Vector4& zAxis,
+         const Vector4& e) : center(c), extents(e) {
+    axes[0] = xAxis;
+    axes[1] = yAxis;
+    axes[2] = zAxis;
+}
+
+OBB::OBB(const AABB& box, const Matrix4x4& mat) {
+    fromRows(box, mat[0], mat[1], mat[2]);
+}
+
+OBB::OBB(const AABB& box, const AffineTransform& transform) {
+    fromRows(box, transform[0], transform[1], transform[2]);
+}
+
+void OBB::fromRows(const AABB& box, const float* r0, const float* r1, const float* r2) {
+    Vector4 c = box.getCenter();
+    Vector4 e = box.getExtents();
+
+    center = Vector4(r0[0]*c[0] + r0[1]*c[1] + r0[2]*c[2] + r0[3],
+                     r1[0]*c[0] + r1[1]*c[1] + r1[2]*c[2] + r1[3],
+                     r2[0]*c[0] + r2[1]*c[1] + r2[2]*c[2] + r2[3]);
+
+    for (int i = 0; i < 3; ++i) {
+        Vector4 column(r0[i], r1[i], r2[i]);
+        float scale = column.magnitude();
+        if (scale > 0.0f) {
+            axes[i] = column * (1.0f / scale);
+            axes[i][3] = 1.0f;
+        } else {
+            // a collapsed axis keeps the default direction, its extent is zero anyway
+            axes[i] = Vector4(i == 0 ? 1.0f : 0.0f, i == 1 ? 1.0f : 0.0f, i == 2 ? 1.0f : 0.0f);
+        }
+        extents[i] = e[i] * scale;
+    }
+}
+
+AABB OBB::toAABB() const {
+    Vector4 half;
+    for (int i = 0; i < 3; ++i) {
+        half[i] = std::fabs(axes[0][i]) * extents[0]
+                + std::fabs(axes[1][i]) * extents[1]
+                + std::fabs(axes[2][i]) * extents[2];
+    }
+    Vector4 min = center - half;
+    Vector4 max = center + half;
+    min[3] = 1.0f;
+    max[3] = 1.0f;
+    return AABB(min, max);
+}
+
+bool OBB::overlaps(const OBB& b) const {
+    // Gottschalk's separating axis test, done in this box's frame
+    float r[3][3], absR[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            r[i][j] = axes[i].dot(b.axes[j]);
+            absR[i][j] = std::fabs(r[i][j]) + SAT_EPSILON;
+        }
+    }
+
+    Vector4 offset = b.center - center;
+    float t[3] = {offset.dot(axes[0]), offset.dot(axes[1]), offset.dot(axes[2])};
+
+    float ra, rb;
+
+    // this box's face normals
+    for (int i = 0; i < 3; ++i) {
+        ra = extents[i];
+        rb = b.extents[0]*absR[i][0] + b.extents[1]*absR[i][1] + b.extents[2]*absR[i][2];
+        if (std::fabs(t[i]) > ra + rb) {
+            return false;
+        }
+    }
+
+    // the other box's face normals
+    for (int j = 0; j < 3; ++j) {
+        ra = extents[0]*absR[0][j] + extents[1]*absR[1][j] + extents[2]*absR[2][j];
+        rb = b.extents[j];
+        if (std::fabs(t[0]*r[0][j] + t[1]*r[1][j] + t[2]*r[2][j]) > ra + rb) {
+            return false;
+        }
+    }
+
+    // cross products of each pair of edges
+    for (int i = 0; i < 3; ++i) {
+        int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; ++j) {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            ra = extents[i1]*absR[i2][j] + extents[i2]*absR[i1][j];
+            rb = b.extents[j1]*absR[i][j2] + b.extents[j2]*absR[i][j1];
+            if (std::fabs(t[i2]*r[i1][j] - t[i1]*r[i2][j]) > ra + rb) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool OBB::contains(const Vector4& point) const {
+    Vector4 offset = point - center;
+    for (int i = 0; i < 3; ++i) {
+        if (std::fabs(offset.dot(axes[i])) > extents[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::ostream& Math3D::operator <<(std::ostream &outs, const OBB &box) {
+    outs << box.getCenter() << ", " << box.getAxis(0) << ", " << box.getAxis(1) << ", " << box.getAxis(2)
+         << ", " << box.getExtents();
+
+    return outs;
+}
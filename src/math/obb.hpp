@@ -0,0 +1,61 @@
+#ifndef OBB_HPP
+#define OBB_HPP
+
+#include <iostream>
+
+#include "math/aabb.hpp"
+#include "math/affinetransform.hpp"
+#include "math/matrix4x4.hpp"
+#include "math/vector4.hpp"
+
+namespace Math3D {
+    /*
+    An oriented bounding box, stored as its center, three unit axes and the half size along each axis.
+    */
+    class OBB {
+     public:
+        /*
+        Returns a box at the origin with zero size.
+        */
+        OBB();
+        /*
+        Returns the box with the given center, axes (assumed to be unit length and orthogonal)
+        and half sizes.
+        */
+        OBB(const Vector4& center, const Vector4& xAxis, const Vector4& yAxis, const Vector4& zAxis,
+            const Vector4& extents);
+        /*
+        Returns the box transformed by the matrix. Any scale in the matrix is moved into the extents,
+        shear is not supported.
+        */
+        OBB(const AABB& box, const Matrix4x4& mat);
+        OBB(const AABB& box, const AffineTransform& transform);
+
+        const Vector4& getCenter() const { return center; }
+        const Vector4& getAxis(int i) const { return axes[i]; }
+        const Vector4& getExtents() const { return extents; }
+        /*
+        Returns the smallest axis aligned box containing the box.
+        */
+        AABB toAABB() const;
+        /*
+        Returns whether the boxes overlap, using the separating axis test.
+        */
+        bool overlaps(const OBB& b) const;
+        /*
+        Returns whether the box contains the point.
+        */
+        bool contains(const Vector4& point) const;
+
+     private:
+        Vector4 center;
+        Vector4 axes[3];
+        Vector4 extents;
+
+        void fromRows(const AABB& box, const float* r0, const float* r1, const float* r2);
+    };
+
+    std::ostream& operator <<(std::ostream &outs, const OBB &box);
+}
+
+#endif
@@ -0,0 +1,254 @@
+#ifndef PACKET_HPP
+#define PACKET_HPP
+
+#include "math/affinetransform.hpp"
+#include "math/matrix4x4.hpp"
+#include "math/simd.hpp"
+#include "math/vector4.hpp"
+
+namespace Math3D {
+    /*
+    Packets hold one value per SIMD lane (structure of arrays), so every operation works on 4 or 8
+    independent values at once. W is SIMD::Wide4 or SIMD::Wide8, use the typedefs at the bottom of the file.
+    Everything is inline and compiles down to straight-line SIMD code.
+    */
+    template <typename W>
+    class MaskPacket {
+     public:
+        typedef typename W::type Lanes;
+
+        MaskPacket() : lanes(W::splat(0.0f)) {}
+        explicit MaskPacket(Lanes l) : lanes(l) {}
+        /*
+        Returns a bit per lane, lane 0 in bit 0.
+        */
+        int bits() const { return SIMD::movemask(lanes); }
+        bool any() const { return bits() != 0; }
+        bool all() const { return bits() == (1 << W::WIDTH) - 1; }
+        bool none() const { return bits() == 0; }
+
+        MaskPacket operator&(const MaskPacket& b) const { return MaskPacket(SIMD::maskAnd(lanes, b.lanes)); }
+        MaskPacket operator|(const MaskPacket& b) const { return MaskPacket(SIMD::maskOr(lanes, b.lanes)); }
+
+        Lanes lanes;
+    };
+
+    template <typename W>
+    class FloatPacket {
+     public:
+        typedef typename W::type Lanes;
+        static const int WIDTH = W::WIDTH;
+
+        FloatPacket() : lanes(W::splat(0.0f)) {}
+        explicit FloatPacket(Lanes l) : lanes(l) {}
+        /*
+        Returns a packet with every lane set to a.
+        */
+        FloatPacket(float a) : lanes(W::splat(a)) {}
+        /*
+        Loads WIDTH floats, with no alignment requirement.
+        */
+        static FloatPacket load(const float* p) { return FloatPacket(W::load(p)); }
+        void store(float* p) const { W::store(p, lanes); }
+
+        FloatPacket operator+(const FloatPacket& b) const { return FloatPacket(SIMD::add(lanes, b.lanes)); }
+        FloatPacket operator-(const FloatPacket& b) const { return FloatPacket(SIMD::sub(lanes, b.lanes)); }
+        FloatPacket operator*(const FloatPacket& b) const { return FloatPacket(SIMD::mul(lanes, b.lanes)); }
+        FloatPacket operator/(const FloatPacket& b) const { return FloatPacket(SIMD::div(lanes, b.lanes)); }
+        FloatPacket operator-() const { return FloatPacket(SIMD::sub(W::splat(0.0f), lanes)); }
+
+        MaskPacket<W> operator<(const FloatPacket& b) const { return MaskPacket<W>(SIMD::cmplt(lanes, b.lanes)); }
+        MaskPacket<W> operator<=(const FloatPacket& b) const { return MaskPacket<W>(SIMD::cmple(lanes, b.lanes)); }
+        MaskPacket<W> operator>(const FloatPacket& b) const { return MaskPacket<W>(SIMD::cmpgt(lanes, b.lanes)); }
+        MaskPacket<W> operator>=(const FloatPacket& b) const { return MaskPacket<W>(SIMD::cmpge(lanes, b.lanes)); }
+
+        Lanes lanes;
+    };
+
+    template <typename W>
+    inline FloatPacket<W> min(const FloatPacket<W>& a, const FloatPacket<W>& b) {
+        return FloatPacket<W>(SIMD::min(a.lanes, b.lanes));
+    }
+
+    template <typename W>
+    inline FloatPacket<W> max(const FloatPacket<W>& a, const FloatPacket<W>& b) {
+        return FloatPacket<W>(SIMD::max(a.lanes, b.lanes));
+    }
+
+    template <typename W>
+    inline FloatPacket<W> abs(const FloatPacket<W>& a) {
+        return FloatPacket<W>(SIMD::abs(a.lanes));
+    }
+
+    template <typename W>
+    inline FloatPacket<W> sqrt(const FloatPacket<W>& a) {
+        return FloatPacket<W>(SIMD::sqrt(a.lanes));
+    }
+    /*
+    Approximate reciprocal square root, see SIMD::rsqrt.
+    */
+    template <typename W>
+    inline FloatPacket<W> rsqrt(const FloatPacket<W>& a) {
+        return FloatPacket<W>(SIMD::rsqrt(a.lanes));
+    }
+    /*
+    Returns a where the mask is set and b elsewhere.
+    */
+    template <typename W>
+    inline FloatPacket<W> select(const MaskPacket<W>& mask, const FloatPacket<W>& a, const FloatPacket<W>& b) {
+        return FloatPacket<W>(SIMD::select(mask.lanes, a.lanes, b.lanes));
+    }
+
+    template <typename W>
+    class Vec3Packet {
+     public:
+        typedef FloatPacket<W> Float;
+        static const int WIDTH = W::WIDTH;
+
+        Vec3Packet() {}
+        Vec3Packet(const Float& px, const Float& py, const Float& pz) : x(px), y(py), z(pz) {}
+        /*
+        Returns a packet with every lane set to the vector.
+        */
+        explicit Vec3Packet(const Vector4& v) : x(v[0]), y(v[1]), z(v[2]) {}
+        /*
+        Loads WIDTH vectors from separate x, y and z arrays.
+        */
+        static Vec3Packet load(const float* xs, const float* ys, const float* zs) {
+            return Vec3Packet(Float::load(xs), Float::load(ys), Float::load(zs));
+        }
+        /*
+        Loads WIDTH vectors from an array of Vector4 (array of structures), ignoring w.
+        */
+        static Vec3Packet gather(const Vector4* points) {
+            float xs[WIDTH], ys[WIDTH], zs[WIDTH];
+            for (int i = 0; i < WIDTH; ++i) {
+                xs[i] = points[i][0];
+                ys[i] = points[i][1];
+                zs[i] = points[i][2];
+            }
+            return load(xs, ys, zs);
+        }
+
+        void store(float* xs, float* ys, float* zs) const {
+            x.store(xs);
+            y.store(ys);
+            z.store(zs);
+        }
+        /*
+        Returns the vector in the lane.
+        */
+        Vector4 get(int lane) const {
+            float xs[WIDTH], ys[WIDTH], zs[WIDTH];
+            store(xs, ys, zs);
+            return Vector4(xs[lane], ys[lane], zs[lane]);
+        }
+        /*
+        Returns the dot product of the vectors in each lane, summed as (x + y) + z like Vector4::dot.
+        */
+        Float dot(const Vec3Packet& b) const {
+            return (x*b.x + y*b.y) + z*b.z;
+        }
+        /*
+        Returns the cross product of the vectors in each lane.
+        */
+        Vec3Packet cross(const Vec3Packet& b) const {
+            return Vec3Packet(y*b.z - z*b.y, z*b.x - x*b.z, x*b.y - y*b.x);
+        }
+
+        Float magnitude() const {
+            return sqrt(dot(*this));
+        }
+        /*
+        Returns the unit vector in each lane, using the approximate rsqrt.
+        */
+        Vec3Packet unit() const {
+            return *this * rsqrt(dot(*this));
+        }
+
+        Vec3Packet operator+(const Vec3Packet& b) const { return Vec3Packet(x + b.x, y + b.y, z + b.z); }
+        Vec3Packet operator-(const Vec3Packet& b) const { return Vec3Packet(x - b.x, y - b.y, z - b.z); }
+        Vec3Packet operator*(const Vec3Packet& b) const { return Vec3Packet(x * b.x, y * b.y, z * b.z); }
+        Vec3Packet operator*(const Float& a) const { return Vec3Packet(x * a, y * a, z * a); }
+        Vec3Packet operator/(const Float& a) const { return Vec3Packet(x / a, y / a, z / a); }
+        Vec3Packet operator-() const { return Vec3Packet(-x, -y, -z); }
+
+        Float x;
+        Float y;
+        Float z;
+    };
+
+    template <typename W>
+    inline Vec3Packet<W> min(const Vec3Packet<W>& a, const Vec3Packet<W>& b) {
+        return Vec3Packet<W>(min(a.x, b.x), min(a.y, b.y), min(a.z, b.z));
+    }
+
+    template <typename W>
+    inline Vec3Packet<W> max(const Vec3Packet<W>& a, const Vec3Packet<W>& b) {
+        return Vec3Packet<W>(max(a.x, b.x), max(a.y, b.y), max(a.z, b.z));
+    }
+
+    template <typename W>
+    inline Vec3Packet<W> abs(const Vec3Packet<W>& a) {
+        return Vec3Packet<W>(abs(a.x), abs(a.y), abs(a.z));
+    }
+
+    template <typename W>
+    inline Vec3Packet<W> select(const MaskPacket<W>& mask, const Vec3Packet<W>& a, const Vec3Packet<W>& b) {
+        return Vec3Packet<W>(select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z));
+    }
+
+    namespace Detail {
+        /*
+        Multiplies the packet by the upper 3x4 of a matrix given as rows, with the matrix broadcast to every lane.
+        w is 1 for points (translation applied) and 0 for directions.
+        */
+        template <typename W>
+        inline Vec3Packet<W> transformRows(const float* r0, const float* r1, const float* r2,
+                                           const Vec3Packet<W>& p, bool point) {
+            typedef FloatPacket<W> Float;
+            Float x = (Float(r0[0])*p.x + Float(r0[1])*p.y) + Float(r0[2])*p.z;
+            Float y = (Float(r1[0])*p.x + Float(r1[1])*p.y) + Float(r1[2])*p.z;
+            Float z = (Float(r2[0])*p.x + Float(r2[1])*p.y) + Float(r2[2])*p.z;
+            if (point) {
+                x = x + Float(r0[3]);
+                y = y + Float(r1[3]);
+                z = z + Float(r2[3]);
+            }
+            return Vec3Packet<W>(x, y, z);
+        }
+    }
+    /*
+    Returns the points in the packet transformed by the matrix, which is assumed to be affine.
+    */
+    template <typename W>
+    inline Vec3Packet<W> transformPoint(const Matrix4x4& mat, const Vec3Packet<W>& p) {
+        return Detail::transformRows(mat[0], mat[1], mat[2], p, true);
+    }
+
+    template <typename W>
+    inline Vec3Packet<W> transformPoint(const AffineTransform& transform, const Vec3Packet<W>& p) {
+        return Detail::transformRows(transform[0], transform[1], transform[2], p, true);
+    }
+    /*
+    Returns the directions in the packet transformed by the matrix (translation is ignored).
+    */
+    template <typename W>
+    inline Vec3Packet<W> transformDirection(const Matrix4x4& mat, const Vec3Packet<W>& p) {
+        return Detail::transformRows(mat[0], mat[1], mat[2], p, false);
+    }
+
+    template <typename W>
+    inline Vec3Packet<W> transformDirection(const AffineTransform& transform, const Vec3Packet<W>& p) {
+        return Detail::transformRows(transform[0], transform[1], transform[2], p, false);
+    }
+
+    typedef MaskPacket<SIMD::Wide4> Mask4;
+    typedef MaskPacket<SIMD::Wide8> Mask8;
+    typedef FloatPacket<SIMD::Wide4> Floatx4;
+    typedef FloatPacket<SIMD::Wide8> Floatx8;
+    typedef Vec3Packet<SIMD::Wide4> Vec3x4;
+    typedef Vec3Packet<SIMD::Wide8> Vec3x8;
+}
+
+#endif
@@ -0,0 +1,196 @@
+#include "math/quaternion.hpp"
+
+#include <cmath>
+
+#include "math/constants.hpp"
+
+using namespace Math3D;
+
+namespace {
+    /*
+    Writes the rotation matrix rows of the unit quaternion q (x, y, z, w) into r0, r1, r2.
+    */
+    void rotationRows(const float* values, SIMD::float4& r0, SIMD::float4& r1, SIMD::float4& r2) {
+        SIMD::float4 q = SIMD::load(values);
+        SIMD::float4 q2 = SIMD::add(q, q);
+
+        // row 0: 1 - (yy2 + zz2), xy2 - zw2, xz2 + yw2
+        SIMD::float4 a = SIMD::mul(SIMD::shuffle<1, 0, 0, 3>(q), SIMD::shuffle<1, 1, 2, 3>(q2));
+        SIMD::float4 b = SIMD::mul(SIMD::shuffle<2, 3, 3, 3>(q), SIMD::shuffle<2, 2, 1, 3>(q2));
+        r0 = SIMD::add(SIMD::set(1.0f, 0.0f, 0.0f, 0.0f),
+                       SIMD::add(SIMD::mul(a, SIMD::set(-1.0f, 1.0f, 1.0f, 0.0f)),
+                                 SIMD::mul(b, SIMD::set(-1.0f, -1.0f, 1.0f, 0.0f))));
+
+        // row 1: xy2 + zw2, 1 - (xx2 + zz2), yz2 - xw2
+        a = SIMD::mul(SIMD::shuffle<0, 0, 1, 3>(q), SIMD::shuffle<1, 0, 2, 3>(q2));
+        b = SIMD::mul(SIMD::shuffle<3, 2, 3, 3>(q), SIMD::shuffle<2, 2, 0, 3>(q2));
+        r1 = SIMD::add(SIMD::set(0.0f, 1.0f, 0.0f, 0.0f),
+                       SIMD::add(SIMD::mul(a, SIMD::set(1.0f, -1.0f, 1.0f, 0.0f)),
+                                 SIMD::mul(b, SIMD::set(1.0f, -1.0f, -1.0f, 0.0f))));
+
+        // row 2: xz2 - yw2, yz2 + xw2, 1 - (xx2 + yy2)
+        a = SIMD::mul(SIMD::shuffle<0, 1, 0, 3>(q), SIMD::shuffle<2, 2, 0, 3>(q2));
+        b = SIMD::mul(SIMD::shuffle<3, 3, 1, 3>(q), SIMD::shuffle<1, 0, 1, 3>(q2));
+        r2 = SIMD::add(SIMD::set(0.0f, 0.0f, 1.0f, 0.0f),
+                       SIMD::add(SIMD::mul(a, SIMD::set(1.0f, 1.0f, -1.0f, 0.0f)),
+                                 SIMD::mul(b, SIMD::set(-1.0f, 1.0f, -1.0f, 0.0f))));
+    }
+
+    /*
+    Returns the quaternion of an orthonormal 3x3 rotation given by its rows (Shepperd's method).
+    */
+    Quaternion fromRows(const float* r0, const float* r1, const float* r2) {
+        float trace = r0[0] + r1[1] + r2[2];
+        if (trace > 0.0f) {
+            float s = 0.5f / std::sqrt(trace + 1.0f);
+            return Quaternion((r2[1] - r1[2]) * s, (r0[2] - r2[0]) * s, (r1[0] - r0[1]) * s, 0.25f / s);
+        } else if (r0[0] > r1[1] && r0[0] > r2[2]) {
+            float s = 2.0f * std::sqrt(1.0f + r0[0] - r1[1] - r2[2]);
+            return Quaternion(0.25f * s, (r0[1] + r1[0]) / s, (r0[2] + r2[0]) / s, (r2[1] - r1[2]) / s);
+        } else if (r1[1] > r2[2]) {
+            float s = 2.0f * std::sqrt(1.0f + r1[1] - r0[0] - r2[2]);
+            return Quaternion((r0[1] + r1[0]) / s, 0.25f * s, (r1[2] + r2[1]) / s, (r0[2] - r2[0]) / s);
+        } else {
+            float s = 2.0f * std::sqrt(1.0f + r2[2] - r0[0] - r1[1]);
+            return Quaternion((r0[2] + r2[0]) / s, (r1[2] + r2[1]) / s, 0.25f * s, (r1[0] - r0[1]) / s);
+        }
+    }
+
+    /*
+    Returns the quaternion of a 3x3 rotation given by its rows that may also be scaled along each axis. The
+    columns are the rotated axes times their scale, so dividing each by its length leaves the rotation.
+    */
+    Quaternion fromScaledRows(const float* r0, const float* r1, const float* r2) {
+        float rows[3][3];
+        for (int column = 0; column < 3; column++) {
+            float length = std::sqrt(r0[column] * r0[column] + r1[column] * r1[column] + r2[column] * r2[column]);
+            float k = length > 0.0f ? 1.0f / length : 1.0f;
+            rows[0][column] = r0[column] * k;
+            rows[1][column] = r1[column] * k;
+            rows[2][column] = r2[column] * k;
+        }
+        return fromRows(rows[0], rows[1], rows[2]);
+    }
+}
+
+Quaternion Quaternion::fromAxisAngle(const Vector4& axis, float angle) {
+    float s = std::sin(angle / 2);
+    return Quaternion(axis[0] * s, axis[1] * s, axis[2] * s, std::cos(angle / 2));
+}
+
+Quaternion Quaternion::fromEuler(float x, float y, float z) {
+    // same order as Matrix4x4::fromEuler, which is the rotation about x, then y, then z applied right to left
+    float sx = std::sin(x / 2), cx = std::cos(x / 2);
+    float sy = std::sin(y / 2), cy = std::cos(y / 2);
+    float sz = std::sin(z / 2), cz = std::cos(z / 2);
+
+    return Quaternion(cx * sy * sz + sx * cy * cz,
+                      cx * sy * cz - sx * cy * sz,
+                      cx * cy * sz + sx * sy * cz,
+                      cx * cy * cz - sx * sy * sz);
+}
+
+Quaternion Quaternion::fromMatrix(const Matrix4x4& mat) {
+    return fromScaledRows(mat[0], mat[1], mat[2]);
+}
+
+Quaternion Quaternion::fromTransform(const AffineTransform& transform) {
+    return fromScaledRows(transform[0], transform[1], transform[2]);
+}
+
+Quaternion Quaternion::nlerp(const Quaternion& a, const Quaternion& b, float t) {
+    // q and -q are the same rotation, so flip b if needed to take the shorter path
+    float wb = a.dot(b) < 0.0f ? -t : t;
+    Quaternion out;
+    SIMD::store(out.values, SIMD::add(SIMD::mul(SIMD::load(a.values), SIMD::splat(1.0f - t)),
+                                      SIMD::mul(SIMD::load(b.values), SIMD::splat(wb))));
+    return out.unit();
+}
+
+Quaternion Quaternion::slerp(const Quaternion& a, const Quaternion& b, float t) {
+    float cosTheta = a.dot(b);
+    float sign = 1.0f;
+    if (cosTheta < 0.0f) {
+        cosTheta = -cosTheta;
+        sign = -1.0f;
+    }
+
+    // nearly parallel rotations are numerically unstable for slerp but nlerp is accurate there
+    if (cosTheta > 1.0f - EPSILON) {
+        return nlerp(a, b, t);
+    }
+
+    float theta = std::acos(cosTheta);
+    float invSin = 1.0f / std::sin(theta);
+    float wa = std::sin((1.0f - t) * theta) * invSin;
+    float wb = std::sin(t * theta) * invSin * sign;
+
+    Quaternion out;
+    SIMD::store(out.values, SIMD::add(SIMD::mul(SIMD::load(a.values), SIMD::splat(wa)),
+                                      SIMD::mul(SIMD::load(b.values), SIMD::splat(wb))));
+    return out;
+}
+
+Matrix4x4 Quaternion::toMatrix() const {
+    Matrix4x4 out;
+
+    SIMD::float4 r0, r1, r2;
+    rotationRows(values, r0, r1, r2);
+    SIMD::store(out[0], r0);
+    SIMD::store(out[1], r1);
+    SIMD::store(out[2], r2);
+
+    return out;
+}
+
+AffineTransform Quaternion::toTransform() const {
+    AffineTransform out;
+
+    SIMD::float4 r0, r1, r2;
+    rotationRows(values, r0, r1, r2);
+    SIMD::store(out[0], r0);
+    SIMD::store(out[1], r1);
+    SIMD::store(out[2], r2);
+
+    return out;
+}
+
+Quaternion Quaternion::integrate(const Vector4& angularVelocity, float dt) const {
+    // dq/dt = 0.5 * w * q, where w is the angular velocity as a pure quaternion
+    float h = 0.5f * dt;
+    Quaternion spin(angularVelocity[0] * h, angularVelocity[1] * h, angularVelocity[2] * h, 0.0f);
+    Quaternion delta = spin * (*this);
+
+    Quaternion out;
+    SIMD::store(out.values, SIMD::add(SIMD::load(values), SIMD::load(delta.values)));
+    return out.unit();
+}
+
+float Quaternion::magnitude() const {
+    return std::sqrt(dot(*this));
+}
+
+Quaternion Quaternion::unit() const {
+    Quaternion out;
+    SIMD::store(out.values, SIMD::div(SIMD::load(values), SIMD::splat(magnitude())));
+    return out;
+}
+
+bool Quaternion::operator==(const Quaternion& b) const {
+    for (unsigned int i = 0; i < 4; ++i) {
+        if (fabs(values[i] - b.values[i]) > EPSILON) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Quaternion::operator!=(const Quaternion& b) const {
+    return !operator==(b);
+}
+
+std::ostream& Math3D::operator <<(std::ostream &outs, const Quaternion &quat) {
+    outs << quat[0] << ", " << quat[1] << ", " << quat[2] << ", " << quat[3];
+
+    return outs;
+}
@@ -0,0 +1,181 @@
+#ifndef QUATERNION_HPP
+#define QUATERNION_HPP
+
+#include <iostream>
+
+#include "math/affinetransform.hpp"
+#include "math/matrix4x4.hpp"
+#include "math/simd.hpp"
+#include "math/vector4.hpp"
+
+namespace Math3D {
+    /*
+    A rotation stored as a unit quaternion with its values ordered x, y, z, w.
+    */
+    class Quaternion {
+     public:
+        /*
+        Returns the identity rotation.
+        */
+        Quaternion();
+        /*
+        Returns quaternion with its values set as given ones.
+        */
+        Quaternion(float x, float y, float z, float w);
+        /*
+        Returns the rotation of angle radians around the given unit axis.
+        */
+        static Quaternion fromAxisAngle(const Vector4& axis, float angle);
+        /*
+        Returns the rotation from the x, y, and z euler angles. This is the same rotation as
+        Matrix4x4::fromEuler, but only needs 6 sin/cos calls.
+        */
+        static Quaternion fromEuler(float x, float y, float z);
+        /*
+        Returns the rotation of the matrix. Any scale along the axes is removed first, the axes are assumed to be
+        orthogonal.
+        */
+        static Quaternion fromMatrix(const Matrix4x4& mat);
+        /*
+        Returns the rotation of the transform. Any scale along the axes is removed first, the axes are assumed
+        to be orthogonal.
+        */
+        static Quaternion fromTransform(const AffineTransform& transform);
+        /*
+        Returns the normalized linear interpolation between the rotations, taking the shortest path.
+        */
+        static Quaternion nlerp(const Quaternion& a, const Quaternion& b, float t);
+        /*
+        Returns the spherical linear interpolation between the rotations, taking the shortest path.
+        */
+        static Quaternion slerp(const Quaternion& a, const Quaternion& b, float t);
+        /*
+        Returns the rotation matrix of the quaternion.
+        */
+        Matrix4x4 toMatrix() const;
+        /*
+        Returns the rotation of the quaternion as an affine transform.
+        */
+        AffineTransform toTransform() const;
+        /*
+        Returns the rotation after spinning with the given angular velocity (radians per second, world space)
+        for dt seconds. The result is renormalized.
+        */
+        Quaternion integrate(const Vector4& angularVelocity, float dt) const;
+        /*
+        Returns the conjugate, which is the inverse of a unit quaternion.
+        */
+        Quaternion conjugate() const;
+        /*
+        Returns the dot product of the quaternions.
+        */
+        float dot(const Quaternion& b) const;
+        /*
+        Returns the length of the quaternion.
+        */
+        float magnitude() const;
+        /*
+        Returns the quaternion scaled to unit length.
+        */
+        Quaternion unit() const;
+        /*
+        Returns the vector rotated by the quaternion. The w of the vector is kept.
+        */
+        Vector4 rotate(const Vector4& b) const;
+        /*
+        Returns the rotation that results from applying b and then this rotation.
+        */
+        Quaternion operator*(const Quaternion& b) const;
+
+        bool operator==(const Quaternion&) const;
+        bool operator!=(const Quaternion&) const;
+        /*
+        Allows the quaternion's values to be indexed like Quaternion[i], ordered x, y, z, w
+        */
+        float& operator[](int);
+        const float operator[](int) const;
+        /*
+        Returns pointer to the quaternion's value array
+        */
+        float* getValues();
+        const float* getValues() const;
+
+     private:
+        alignas(16) float values[4];
+    };
+
+    std::ostream& operator <<(std::ostream &outs, const Quaternion &quat);
+
+    inline Quaternion::Quaternion() {
+        values[0] = 0.0f;
+        values[1] = 0.0f;
+        values[2] = 0.0f;
+        values[3] = 1.0f;
+    }
+
+    inline Quaternion::Quaternion(float x, float y, float z, float w) {
+        values[0] = x;
+        values[1] = y;
+        values[2] = z;
+        values[3] = w;
+    }
+
+    inline Quaternion Quaternion::conjugate() const {
+        Quaternion out;
+        SIMD::store(out.values, SIMD::mul(SIMD::load(values), SIMD::set(-1.0f, -1.0f, -1.0f, 1.0f)));
+        return out;
+    }
+
+    inline float Quaternion::dot(const Quaternion& b) const {
+        return values[0] * b.values[0] + values[1] * b.values[1] + values[2] * b.values[2] + values[3] * b.values[3];
+    }
+
+    inline Vector4 Quaternion::rotate(const Vector4& b) const {
+        // v + w*t + u x t, where t = 2 * (u x v) and u is the vector part
+        Vector4 out;
+
+        SIMD::float4 q = SIMD::load(values);
+        SIMD::float4 v = SIMD::load(b.getValues());
+        SIMD::float4 t = SIMD::cross3(q, v);
+        t = SIMD::add(t, t);
+        SIMD::float4 result = SIMD::add(v, SIMD::mul(SIMD::splat(values[3]), t));
+        SIMD::store(out.getValues(), SIMD::add(result, SIMD::cross3(q, t)));
+        out[3] = b[3];
+
+        return out;
+    }
+
+    inline Quaternion Quaternion::operator*(const Quaternion& b) const {
+        Quaternion out;
+
+        SIMD::float4 a = SIMD::load(values);
+        SIMD::float4 q = SIMD::load(b.values);
+        SIMD::float4 flipW = SIMD::set(1.0f, 1.0f, 1.0f, -1.0f);
+
+        SIMD::float4 sum = SIMD::mul(SIMD::splat(values[3]), q);
+        sum = SIMD::add(sum, SIMD::mul(SIMD::mul(SIMD::shuffle<0, 1, 2, 0>(a), SIMD::shuffle<3, 3, 3, 0>(q)), flipW));
+        sum = SIMD::add(sum, SIMD::mul(SIMD::mul(SIMD::shuffle<1, 2, 0, 1>(a), SIMD::shuffle<2, 0, 1, 1>(q)), flipW));
+        sum = SIMD::sub(sum, SIMD::mul(SIMD::shuffle<2, 0, 1, 2>(a), SIMD::shuffle<1, 2, 0, 2>(q)));
+        SIMD::store(out.values, sum);
+
+        return out;
+    }
+
+    inline float& Quaternion::operator[](int i) {
+        return values[i];
+    }
+
+    inline const float Quaternion::operator[](int i) const {
+        return values[i];
+    }
+
+    inline float* Quaternion::getValues() {
+        return values;
+    }
+
+    inline const float* Quaternion::getValues() const {
+        return values;
+    }
+}
+
+#endif
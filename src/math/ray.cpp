@@ -0,0 +1,49 @@
+#include "math/ray.hpp"
+
+#include <cmath>
+#include <utility>
+
+using namespace Math3D;
+
+Ray::Ray() : origin(), direction(0.0f, 0.0f, -1.0f) {
+    precompute();
+}
+
+Ray::Ray(const Vector4& o, const Vector4& d) : origin(o), direction(d) {
+    precompute();
+}
+
+void Ray::precompute() {
+    inverseDirection = Vector4(1.0f / direction[0], 1.0f / direction[1], 1.0f / direction[2]);
+
+    // Woop, Benthin and Wald, "Watertight Ray/Triangle Intersection"
+    int kz = 0;
+    if (std::fabs(direction[1]) > std::fabs(direction[kz])) {
+        kz = 1;
+    }
+    if (std::fabs(direction[2]) > std::fabs(direction[kz])) {
+        kz = 2;
+    }
+    int kx = (kz + 1) % 3;
+    int ky = (kx + 1) % 3;
+    if (direction[kz] < 0.0f) {
+        std::swap(kx, ky); // keep the winding of triangles the same after the permutation
+    }
+    shearAxes[0] = kx;
+    shearAxes[1] = ky;
+    shearAxes[2] = kz;
+
+    shear = Vector4(direction[kx] / direction[kz], direction[ky] / direction[kz], 1.0f / direction[kz]);
+}
+
+Vector4 Ray::pointAt(float t) const {
+    Vector4 out = origin + direction * t;
+    out[3] = 1.0f;
+    return out;
+}
+
+std::ostream& Math3D::operator <<(std::ostream &outs, const Ray &ray) {
+    outs << ray.getOrigin() << ", " << ray.getDirection();
+
+    return outs;
+}
@@ -0,0 +1,55 @@
+#ifndef RAY_HPP
+#define RAY_HPP
+
+#include <iostream>
+
+#include "math/vector4.hpp"
+
+namespace Math3D {
+    /*
+    A ray with an origin and a direction. The reciprocal direction and the shear used by the watertight
+    triangle test are computed once on construction so many intersection tests can share them.
+    */
+    class Ray {
+     public:
+        /*
+        Returns a ray at the origin pointing down the -z axis.
+        */
+        Ray();
+        /*
+        Returns a ray from the origin in the direction, which does not need to be unit length
+        (distances returned by intersection tests are in multiples of the direction).
+        */
+        Ray(const Vector4& origin, const Vector4& direction);
+
+        const Vector4& getOrigin() const { return origin; }
+        const Vector4& getDirection() const { return direction; }
+        const Vector4& getInverseDirection() const { return inverseDirection; }
+        /*
+        Returns the point at distance t along the ray.
+        */
+        Vector4 pointAt(float t) const;
+        /*
+        Returns the axes the watertight test permutes to x, y and z, z being the largest component of the
+        direction.
+        */
+        int getShearAxis(int i) const { return shearAxes[i]; }
+        /*
+        Returns the shear constants of the watertight test.
+        */
+        const Vector4& getShear() const { return shear; }
+
+     private:
+        Vector4 origin;
+        Vector4 direction;
+        Vector4 inverseDirection;
+        Vector4 shear;
+        int shearAxes[3];
+
+        void precompute();
+    };
+
+    std::ostream& operator <<(std::ostream &outs, const Ray &ray);
+}
+
+#endif
@@ -0,0 +1,58 @@
+#include "math/rigidtransform.hpp"
+
+using namespace Math3D;
+
+RigidTransform::RigidTransform(const Matrix4x4& mat) {
+    rotation = Quaternion::fromMatrix(mat);
+    position = mat.position();
+}
+
+RigidTransform::RigidTransform(const AffineTransform& transform) {
+    rotation = Quaternion::fromTransform(transform);
+    position = transform.position();
+}
+
+RigidTransform RigidTransform::interpolate(const RigidTransform& a, const RigidTransform& b, float t) {
+    Vector4 pos = a.position + (b.position - a.position) * t;
+    pos[3] = 1.0f;
+    return RigidTransform(Quaternion::slerp(a.rotation, b.rotation, t), pos);
+}
+
+Matrix4x4 RigidTransform::toMatrix() const {
+    Matrix4x4 out = rotation.toMatrix();
+    out[0][3] = position[0];
+    out[1][3] = position[1];
+    out[2][3] = position[2];
+    return out;
+}
+
+AffineTransform RigidTransform::toTransform() const {
+    AffineTransform out = rotation.toTransform();
+    out[0][3] = position[0];
+    out[1][3] = position[1];
+    out[2][3] = position[2];
+    return out;
+}
+
+RigidTransform RigidTransform::inverse() const {
+    Quaternion inv = rotation.conjugate();
+    Vector4 pos = inv.rotate(position) * -1.0f;
+    pos[3] = 1.0f;
+    return RigidTransform(inv, pos);
+}
+
+bool RigidTransform::operator==(const RigidTransform& b) const {
+    // q and -q are the same rotation
+    Quaternion negated(-b.rotation[0], -b.rotation[1], -b.rotation[2], -b.rotation[3]);
+    return position == b.position && (rotation == b.rotation || rotation == negated);
+}
+
+bool RigidTransform::operator!=(const RigidTransform& b) const {
+    return !operator==(b);
+}
+
+std::ostream& Math3D::operator <<(std::ostream &outs, const RigidTransform &transform) {
+    outs << transform.getRotation() << ", " << transform.getPosition();
+
+    return outs;
+}
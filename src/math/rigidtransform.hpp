@@ -0,0 +1,92 @@
+#ifndef RIGIDTRANSFORM_HPP
+#define RIGIDTRANSFORM_HPP
+
+#include <iostream>
+
+#include "math/affinetransform.hpp"
+#include "math/matrix4x4.hpp"
+#include "math/quaternion.hpp"
+#include "math/vector4.hpp"
+
+namespace Math3D {
+    /*
+    A rotation and position with no scale, stored as a quaternion and a vector (32 bytes).
+    */
+    class RigidTransform {
+     public:
+        /*
+        Returns identity transform.
+        */
+        RigidTransform() {}
+        /*
+        Returns transform at the given position with no rotation.
+        */
+        RigidTransform(const Vector4& pos) : position(pos) {}
+        /*
+        Returns transform with the given rotation and position.
+        */
+        RigidTransform(const Quaternion& rot, const Vector4& pos) : rotation(rot), position(pos) {}
+        /*
+        Returns transform from the matrix, dropping any scale. The matrix's axes are assumed to be orthogonal.
+        */
+        explicit RigidTransform(const Matrix4x4& mat);
+        /*
+        Returns transform from the affine transform, dropping any scale. Its axes are assumed to be orthogonal.
+        */
+        explicit RigidTransform(const AffineTransform& transform);
+        /*
+        Returns the interpolation between the transforms, with the rotation slerped and the position lerped.
+        */
+        static RigidTransform interpolate(const RigidTransform& a, const RigidTransform& b, float t);
+        /*
+        Returns the full 4x4 matrix of the transform.
+        */
+        Matrix4x4 toMatrix() const;
+        /*
+        Returns the transform as an affine transform.
+        */
+        AffineTransform toTransform() const;
+        /*
+        Returns the inverse of the transform.
+        */
+        RigidTransform inverse() const;
+
+        void setRotation(const Quaternion& rot) { rotation = rot; }
+        const Quaternion& getRotation() const { return rotation; }
+
+        void setPosition(const Vector4& pos) { position = pos; }
+        const Vector4& getPosition() const { return position; }
+        /*
+        Returns the transform that results from this transform being composed with another (this * b).
+        */
+        RigidTransform operator*(const RigidTransform& b) const;
+        /*
+        Returns the vector transformed by this transform. The vector's w scales the position, so a w of 0
+        transforms a direction.
+        */
+        Vector4 operator*(const Vector4& b) const;
+
+        bool operator==(const RigidTransform&) const;
+        bool operator!=(const RigidTransform&) const;
+
+     private:
+        Quaternion rotation;
+        Vector4 position;
+    };
+
+    std::ostream& operator <<(std::ostream &outs, const RigidTransform &transform);
+
+    inline RigidTransform RigidTransform::operator*(const RigidTransform& b) const {
+        return RigidTransform(rotation * b.rotation, operator*(b.position));
+    }
+
+    inline Vector4 RigidTransform::operator*(const Vector4& b) const {
+        Vector4 out = rotation.rotate(b);
+        out[0] += position[0] * b[3];
+        out[1] += position[1] * b[3];
+        out[2] += position[2] * b[3];
+        return out;
+    }
+}
+
+#endif
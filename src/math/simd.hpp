@@ -0,0 +1,681 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+/*
+The SIMD backend is selected at compile time. SSE is used on x86 and NEON on ARM, otherwise
+(or when MATH3D_NO_SIMD is defined) a scalar fallback with identical results is used.
+The 8 wide float8 type maps to AVX when the compiler targets it (e.g. -mavx or -march=native),
+otherwise it is a pair of float4 so code written against it runs as two 4 wide passes.
+*/
+#include <cmath>
+
+#if !defined(MATH3D_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+    #define MATH3D_SIMD_SSE
+    #include <xmmintrin.h>
+    #if defined(__AVX__)
+        #define MATH3D_SIMD_AVX
+        #include <immintrin.h>
+    #endif
+#elif !defined(MATH3D_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+    #define MATH3D_SIMD_NEON
+    #include <arm_neon.h>
+#else
+    #define MATH3D_SIMD_SCALAR
+    #include <cstdint>
+    #include <cstring>
+#endif
+
+namespace Math3D {
+    namespace SIMD {
+    #if defined(MATH3D_SIMD_SSE)
+        typedef __m128 float4;
+    #elif defined(MATH3D_SIMD_NEON)
+        typedef float32x4_t float4;
+    #else
+        struct float4 {
+            float v[4];
+        };
+    #endif
+
+        /*
+        Loads four floats from a 16 byte aligned address.
+        */
+        inline float4 load(const float* p) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_load_ps(p);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vld1q_f32(p);
+        #else
+            float4 out = {{p[0], p[1], p[2], p[3]}};
+            return out;
+        #endif
+        }
+        /*
+        Loads four floats from an address with no alignment requirement.
+        */
+        inline float4 loadUnaligned(const float* p) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_loadu_ps(p);
+        #else
+            return load(p);
+        #endif
+        }
+        /*
+        Stores four floats to a 16 byte aligned address.
+        */
+        inline void store(float* p, float4 a) {
+        #if defined(MATH3D_SIMD_SSE)
+            _mm_store_ps(p, a);
+        #elif defined(MATH3D_SIMD_NEON)
+            vst1q_f32(p, a);
+        #else
+            p[0] = a.v[0];
+            p[1] = a.v[1];
+            p[2] = a.v[2];
+            p[3] = a.v[3];
+        #endif
+        }
+        /*
+        Stores four floats to an address with no alignment requirement.
+        */
+        inline void storeUnaligned(float* p, float4 a) {
+        #if defined(MATH3D_SIMD_SSE)
+            _mm_storeu_ps(p, a);
+        #else
+            store(p, a);
+        #endif
+        }
+        /*
+        Returns a vector with the lanes set to x, y, z, w.
+        */
+        inline float4 set(float x, float y, float z, float w) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_setr_ps(x, y, z, w);
+        #else
+            float tmp[4] = {x, y, z, w};
+            return loadUnaligned(tmp);
+        #endif
+        }
+        /*
+        Returns a vector with every lane set to a.
+        */
+        inline float4 splat(float a) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_set1_ps(a);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vdupq_n_f32(a);
+        #else
+            float4 out = {{a, a, a, a}};
+            return out;
+        #endif
+        }
+
+        inline float4 add(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_add_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vaddq_f32(a, b);
+        #else
+            float4 out = {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+            return out;
+        #endif
+        }
+
+        inline float4 sub(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_sub_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vsubq_f32(a, b);
+        #else
+            float4 out = {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+            return out;
+        #endif
+        }
+
+        inline float4 mul(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_mul_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vmulq_f32(a, b);
+        #else
+            float4 out = {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+            return out;
+        #endif
+        }
+        /*
+        Division is exact (IEEE) on every backend, NEON has no vector divide on ARMv7 so it is done per lane.
+        */
+        inline float4 div(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_div_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON) && defined(__aarch64__)
+            return vdivq_f32(a, b);
+        #else
+            float x[4], y[4];
+            storeUnaligned(x, a);
+            storeUnaligned(y, b);
+            return set(x[0] / y[0], x[1] / y[1], x[2] / y[2], x[3] / y[3]);
+        #endif
+        }
+
+        inline float4 min(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_min_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vminq_f32(a, b);
+        #else
+            float4 out = {{a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1],
+                           a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3]}};
+            return out;
+        #endif
+        }
+
+        inline float4 max(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_max_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vmaxq_f32(a, b);
+        #else
+            float4 out = {{a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1],
+                           a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3]}};
+            return out;
+        #endif
+        }
+        /*
+        Returns the absolute value of every lane.
+        */
+        inline float4 abs(float4 a) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vabsq_f32(a);
+        #else
+            float4 out = {{a.v[0] < 0 ? -a.v[0] : a.v[0], a.v[1] < 0 ? -a.v[1] : a.v[1],
+                           a.v[2] < 0 ? -a.v[2] : a.v[2], a.v[3] < 0 ? -a.v[3] : a.v[3]}};
+            return out;
+        #endif
+        }
+        /*
+        Square root, exact (IEEE) on every backend.
+        */
+        inline float4 sqrt(float4 a) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_sqrt_ps(a);
+        #elif defined(MATH3D_SIMD_NEON) && defined(__aarch64__)
+            return vsqrtq_f32(a);
+        #else
+            float x[4];
+            storeUnaligned(x, a);
+            return set(std::sqrt(x[0]), std::sqrt(x[1]), std::sqrt(x[2]), std::sqrt(x[3]));
+        #endif
+        }
+        /*
+        Reciprocal square root. SSE and NEON refine the hardware estimate with Newton-Raphson to about
+        22 bits, so results differ slightly from the scalar fallback's exact 1 / sqrt(a).
+        */
+        inline float4 rsqrt(float4 a) {
+        #if defined(MATH3D_SIMD_SSE)
+            __m128 r = _mm_rsqrt_ps(a);
+            __m128 half = _mm_mul_ps(_mm_set1_ps(0.5f), a);
+            return _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half, _mm_mul_ps(r, r))));
+        #elif defined(MATH3D_SIMD_NEON)
+            float32x4_t r = vrsqrteq_f32(a);
+            r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(a, r), r));
+            return vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(a, r), r));
+        #else
+            float4 out = {{1.0f / std::sqrt(a.v[0]), 1.0f / std::sqrt(a.v[1]),
+                           1.0f / std::sqrt(a.v[2]), 1.0f / std::sqrt(a.v[3])}};
+            return out;
+        #endif
+        }
+
+    #if defined(MATH3D_SIMD_SCALAR)
+        namespace Detail {
+            inline float maskLane(bool set) {
+                std::uint32_t bits = set ? 0xFFFFFFFFu : 0u;
+                float out;
+                std::memcpy(&out, &bits, sizeof(out));
+                return out;
+            }
+
+            inline std::uint32_t laneBits(float a) {
+                std::uint32_t bits;
+                std::memcpy(&bits, &a, sizeof(bits));
+                return bits;
+            }
+
+            inline float fromBits(std::uint32_t bits) {
+                float out;
+                std::memcpy(&out, &bits, sizeof(out));
+                return out;
+            }
+        }
+    #endif
+
+        /*
+        Comparisons return a mask with every bit of a lane set where the comparison holds and clear elsewhere.
+        Masks are combined with maskAnd and maskOr and consumed by select and movemask.
+        */
+        inline float4 cmplt(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_cmplt_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vreinterpretq_f32_u32(vcltq_f32(a, b));
+        #else
+            float4 out = {{Detail::maskLane(a.v[0] < b.v[0]), Detail::maskLane(a.v[1] < b.v[1]),
+                           Detail::maskLane(a.v[2] < b.v[2]), Detail::maskLane(a.v[3] < b.v[3])}};
+            return out;
+        #endif
+        }
+
+        inline float4 cmple(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_cmple_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vreinterpretq_f32_u32(vcleq_f32(a, b));
+        #else
+            float4 out = {{Detail::maskLane(a.v[0] <= b.v[0]), Detail::maskLane(a.v[1] <= b.v[1]),
+                           Detail::maskLane(a.v[2] <= b.v[2]), Detail::maskLane(a.v[3] <= b.v[3])}};
+            return out;
+        #endif
+        }
+
+        inline float4 cmpgt(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_cmpgt_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vreinterpretq_f32_u32(vcgtq_f32(a, b));
+        #else
+            float4 out = {{Detail::maskLane(a.v[0] > b.v[0]), Detail::maskLane(a.v[1] > b.v[1]),
+                           Detail::maskLane(a.v[2] > b.v[2]), Detail::maskLane(a.v[3] > b.v[3])}};
+            return out;
+        #endif
+        }
+
+        inline float4 cmpge(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_cmpge_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vreinterpretq_f32_u32(vcgeq_f32(a, b));
+        #else
+            float4 out = {{Detail::maskLane(a.v[0] >= b.v[0]), Detail::maskLane(a.v[1] >= b.v[1]),
+                           Detail::maskLane(a.v[2] >= b.v[2]), Detail::maskLane(a.v[3] >= b.v[3])}};
+            return out;
+        #endif
+        }
+
+        inline float4 maskAnd(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_and_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+        #else
+            float4 out;
+            for (int i = 0; i < 4; ++i) {
+                out.v[i] = Detail::fromBits(Detail::laneBits(a.v[i]) & Detail::laneBits(b.v[i]));
+            }
+            return out;
+        #endif
+        }
+
+        inline float4 maskOr(float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_or_ps(a, b);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+        #else
+            float4 out;
+            for (int i = 0; i < 4; ++i) {
+                out.v[i] = Detail::fromBits(Detail::laneBits(a.v[i]) | Detail::laneBits(b.v[i]));
+            }
+            return out;
+        #endif
+        }
+        /*
+        Returns a where the mask is set and b elsewhere.
+        */
+        inline float4 select(float4 mask, float4 a, float4 b) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        #elif defined(MATH3D_SIMD_NEON)
+            return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+        #else
+            float4 out;
+            for (int i = 0; i < 4; ++i) {
+                out.v[i] = Detail::laneBits(mask.v[i]) ? a.v[i] : b.v[i];
+            }
+            return out;
+        #endif
+        }
+        /*
+        Returns the top (sign) bit of every lane packed into an int, lane 0 in bit 0.
+        */
+        inline int movemask(float4 a) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_movemask_ps(a);
+        #elif defined(MATH3D_SIMD_NEON)
+            uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(a), 31);
+            return static_cast<int>(vgetq_lane_u32(bits, 0) | (vgetq_lane_u32(bits, 1) << 1)
+                                  | (vgetq_lane_u32(bits, 2) << 2) | (vgetq_lane_u32(bits, 3) << 3));
+        #else
+            int out = 0;
+            for (int i = 0; i < 4; ++i) {
+                out |= static_cast<int>(Detail::laneBits(a.v[i]) >> 31) << i;
+            }
+            return out;
+        #endif
+        }
+        /*
+        Returns the first lane of the vector.
+        */
+        inline float first(float4 a) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_cvtss_f32(a);
+        #elif defined(MATH3D_SIMD_NEON)
+            return vgetq_lane_f32(a, 0);
+        #else
+            return a.v[0];
+        #endif
+        }
+        /*
+        Returns the vector with its lanes rotated to y, z, x, w.
+        */
+        inline float4 yzxw(float4 a) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        #else
+            float x[4];
+            storeUnaligned(x, a);
+            return set(x[1], x[2], x[0], x[3]);
+        #endif
+        }
+        /*
+        Returns the vector with its lanes rotated to z, x, y, w.
+        */
+        inline float4 zxyw(float4 a) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+        #else
+            float x[4];
+            storeUnaligned(x, a);
+            return set(x[2], x[0], x[1], x[3]);
+        #endif
+        }
+        /*
+        Returns the vector with its lanes rearranged, so lane 0 of the result is lane X of a and so on.
+        */
+        template <int X, int Y, int Z, int W>
+        inline float4 shuffle(float4 a) {
+        #if defined(MATH3D_SIMD_SSE)
+            return _mm_shuffle_ps(a, a, _MM_SHUFFLE(W, Z, Y, X));
+        #else
+            float x[4];
+            storeUnaligned(x, a);
+            return set(x[X], x[Y], x[Z], x[W]);
+        #endif
+        }
+        /*
+        Transposes the 4x4 matrix whose rows are r0, r1, r2, r3 in place.
+        */
+        inline void transpose(float4& r0, float4& r1, float4& r2, float4& r3) {
+        #if defined(MATH3D_SIMD_SSE)
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        #elif defined(MATH3D_SIMD_NEON)
+            float32x4x2_t t01 = vtrnq_f32(r0, r1);
+            float32x4x2_t t23 = vtrnq_f32(r2, r3);
+            r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+            r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+            r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+            r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+        #else
+            float4 a = r0, b = r1, c = r2, d = r3;
+            float4 o0 = {{a.v[0], b.v[0], c.v[0], d.v[0]}};
+            float4 o1 = {{a.v[1], b.v[1], c.v[1], d.v[1]}};
+            float4 o2 = {{a.v[2], b.v[2], c.v[2], d.v[2]}};
+            float4 o3 = {{a.v[3], b.v[3], c.v[3], d.v[3]}};
+            r0 = o0;
+            r1 = o1;
+            r2 = o2;
+            r3 = o3;
+        #endif
+        }
+        /*
+        Returns the dot product of the first three lanes, summed as (x + y) + z.
+        */
+        inline float dot3(float4 a, float4 b) {
+            float4 m = mul(a, b);
+        #if defined(MATH3D_SIMD_SSE)
+            __m128 sum = _mm_add_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+            return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 2, 2, 2))));
+        #else
+            float x[4];
+            storeUnaligned(x, m);
+            return (x[0] + x[1]) + x[2];
+        #endif
+        }
+        /*
+        Returns the cross product of the first three lanes, the w lane of the result should be ignored.
+        */
+        inline float4 cross3(float4 a, float4 b) {
+            return sub(mul(yzxw(a), zxyw(b)), mul(zxyw(a), yzxw(b)));
+        }
+
+    #if defined(MATH3D_SIMD_AVX)
+        typedef __m256 float8;
+    #else
+        struct float8 {
+            float4 lo;
+            float4 hi;
+        };
+    #endif
+
+        /*
+        Loads eight floats from an address with no alignment requirement.
+        */
+        inline float8 loadUnaligned8(const float* p) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_loadu_ps(p);
+        #else
+            float8 out = {loadUnaligned(p), loadUnaligned(p + 4)};
+            return out;
+        #endif
+        }
+        /*
+        Stores eight floats to an address with no alignment requirement.
+        */
+        inline void storeUnaligned8(float* p, float8 a) {
+        #if defined(MATH3D_SIMD_AVX)
+            _mm256_storeu_ps(p, a);
+        #else
+            storeUnaligned(p, a.lo);
+            storeUnaligned(p + 4, a.hi);
+        #endif
+        }
+        /*
+        Returns a vector with every lane set to a.
+        */
+        inline float8 splat8(float a) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_set1_ps(a);
+        #else
+            float8 out = {splat(a), splat(a)};
+            return out;
+        #endif
+        }
+
+        inline float8 add(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_add_ps(a, b);
+        #else
+            float8 out = {add(a.lo, b.lo), add(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 sub(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_sub_ps(a, b);
+        #else
+            float8 out = {sub(a.lo, b.lo), sub(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 mul(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_mul_ps(a, b);
+        #else
+            float8 out = {mul(a.lo, b.lo), mul(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 div(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_div_ps(a, b);
+        #else
+            float8 out = {div(a.lo, b.lo), div(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 min(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_min_ps(a, b);
+        #else
+            float8 out = {min(a.lo, b.lo), min(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 max(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_max_ps(a, b);
+        #else
+            float8 out = {max(a.lo, b.lo), max(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 abs(float8 a) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+        #else
+            float8 out = {abs(a.lo), abs(a.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 cmplt(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+        #else
+            float8 out = {cmplt(a.lo, b.lo), cmplt(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 cmple(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+        #else
+            float8 out = {cmple(a.lo, b.lo), cmple(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 cmpgt(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+        #else
+            float8 out = {cmpgt(a.lo, b.lo), cmpgt(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 cmpge(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+        #else
+            float8 out = {cmpge(a.lo, b.lo), cmpge(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 maskAnd(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_and_ps(a, b);
+        #else
+            float8 out = {maskAnd(a.lo, b.lo), maskAnd(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 maskOr(float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_or_ps(a, b);
+        #else
+            float8 out = {maskOr(a.lo, b.lo), maskOr(a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 sqrt(float8 a) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_sqrt_ps(a);
+        #else
+            float8 out = {sqrt(a.lo), sqrt(a.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 rsqrt(float8 a) {
+        #if defined(MATH3D_SIMD_AVX)
+            __m256 r = _mm256_rsqrt_ps(a);
+            __m256 half = _mm256_mul_ps(_mm256_set1_ps(0.5f), a);
+            return _mm256_mul_ps(r, _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(half, _mm256_mul_ps(r, r))));
+        #else
+            float8 out = {rsqrt(a.lo), rsqrt(a.hi)};
+            return out;
+        #endif
+        }
+
+        inline float8 select(float8 mask, float8 a, float8 b) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_blendv_ps(b, a, mask);
+        #else
+            float8 out = {select(mask.lo, a.lo, b.lo), select(mask.hi, a.hi, b.hi)};
+            return out;
+        #endif
+        }
+
+        inline int movemask(float8 a) {
+        #if defined(MATH3D_SIMD_AVX)
+            return _mm256_movemask_ps(a);
+        #else
+            return movemask(a.lo) | (movemask(a.hi) << 4);
+        #endif
+        }
+
+        /*
+        Wraps the 4 and 8 wide types so batch kernels can be written once as templates over the width.
+        */
+        struct Wide4 {
+            typedef float4 type;
+            static const int WIDTH = 4;
+            static type load(const float* p) { return loadUnaligned(p); }
+            static void store(float* p, type a) { storeUnaligned(p, a); }
+            static type splat(float a) { return SIMD::splat(a); }
+        };
+
+        struct Wide8 {
+            typedef float8 type;
+            static const int WIDTH = 8;
+            static type load(const float* p) { return loadUnaligned8(p); }
+            static void store(float* p, type a) { storeUnaligned8(p, a); }
+            static type splat(float a) { return splat8(a); }
+        };
+    }
+}
+
+#endif
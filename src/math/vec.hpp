@@ -0,0 +1,183 @@
+#ifndef VEC_HPP
+#define VEC_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+
+#include "math/constants.hpp"
+
+namespace Math3D {
+    namespace Detail {
+        /*
+        Compile-time list of indices 0..N-1, used to expand element-wise operations without loops
+        so that they can be constexpr (std::index_sequence is not available in C++11).
+        */
+        template <std::size_t... I>
+        struct Indices {};
+
+        template <std::size_t N, std::size_t... I>
+        struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+
+        template <std::size_t... I>
+        struct MakeIndices<0, I...> {
+            typedef Indices<I...> type;
+        };
+    }
+
+    /*
+    A tightly packed vector of N values of type T (no padding, sizeof is N * sizeof(T)).
+    */
+    template <std::size_t N, typename T>
+    class Vec {
+        static_assert(N > 0, "Vec must have at least one component");
+
+        typedef typename Detail::MakeIndices<N>::type Indices;
+
+     public:
+        /*
+            Constructs a vector with every component set to zero.
+        */
+        constexpr Vec() : values() {}
+        /*
+            Constructs a vector from exactly N components, like Vec<3, float>(x, y, z).
+        */
+        template <typename... Args, typename = typename std::enable_if<sizeof...(Args) == N>::type>
+        constexpr Vec(Args... args) : values{static_cast<T>(args)...} {}
+        /*
+            Returns a vector with every component set to a.
+        */
+        static constexpr Vec fill(T a) {
+            return fill(a, Indices());
+        }
+        /*
+            Returns the number of components.
+        */
+        static constexpr std::size_t size() {
+            return N;
+        }
+
+        constexpr T x() const {
+            return values[0];
+        }
+        constexpr T y() const {
+            static_assert(N >= 2, "Vec has no y component");
+            return values[1];
+        }
+        constexpr T z() const {
+            static_assert(N >= 3, "Vec has no z component");
+            return values[2];
+        }
+        constexpr T w() const {
+            static_assert(N >= 4, "Vec has no w component");
+            return values[3];
+        }
+        /*
+            Returns the dot product of the vectors.
+        */
+        constexpr T dot(const Vec& b) const {
+            return partial(b, N - 1);
+        }
+        /*
+            Returns the magnitude of the vector.
+        */
+        T magnitude() const {
+            return std::sqrt(dot(*this));
+        }
+        /*
+            Returns the normalized form of the vector.
+        */
+        Vec unit() const {
+            return *this / magnitude();
+        }
+
+        constexpr Vec operator+(const Vec& b) const { return add(b, Indices()); }
+        constexpr Vec operator-(const Vec& b) const { return sub(b, Indices()); }
+        constexpr Vec operator*(const Vec& b) const { return mul(b, Indices()); }
+        constexpr Vec operator/(const Vec& b) const { return div(b, Indices()); }
+        constexpr Vec operator*(T b) const { return scale(b, Indices()); }
+        constexpr Vec operator/(T b) const { return divide(b, Indices()); }
+        constexpr Vec operator-() const { return scale(T(-1), Indices()); }
+
+        /*
+            Compares each component to within EPSILON like Vector4 does, which is exact for integer T.
+        */
+        constexpr bool operator==(const Vec& b) const { return equal(b, 0); }
+        constexpr bool operator!=(const Vec& b) const { return !equal(b, 0); }
+        /*
+            Allows the vector's values to be indexed like Vec[i]
+        */
+        T& operator[](std::size_t i) { return values[i]; }
+        constexpr const T& operator[](std::size_t i) const { return values[i]; }
+        /*
+            Returns pointer to the vector's value array
+        */
+        T* getValues() { return values; }
+        const T* getValues() const { return values; }
+
+     private:
+        T values[N];
+
+        template <std::size_t... I>
+        static constexpr Vec fill(T a, Detail::Indices<I...>) { return Vec((static_cast<void>(I), a)...); }
+        template <std::size_t... I>
+        constexpr Vec add(const Vec& b, Detail::Indices<I...>) const { return Vec((values[I] + b.values[I])...); }
+        template <std::size_t... I>
+        constexpr Vec sub(const Vec& b, Detail::Indices<I...>) const { return Vec((values[I] - b.values[I])...); }
+        template <std::size_t... I>
+        constexpr Vec mul(const Vec& b, Detail::Indices<I...>) const { return Vec((values[I] * b.values[I])...); }
+        template <std::size_t... I>
+        constexpr Vec div(const Vec& b, Detail::Indices<I...>) const { return Vec((values[I] / b.values[I])...); }
+        template <std::size_t... I>
+        constexpr Vec scale(T b, Detail::Indices<I...>) const { return Vec((values[I] * b)...); }
+        template <std::size_t... I>
+        constexpr Vec divide(T b, Detail::Indices<I...>) const { return Vec((values[I] / b)...); }
+
+        // summed left to right like the hand-written Vector4 code
+        constexpr T partial(const Vec& b, std::size_t last) const {
+            return last == 0 ? values[0] * b.values[0] : partial(b, last - 1) + values[last] * b.values[last];
+        }
+        constexpr bool equal(const Vec& b, std::size_t i) const {
+            return i == N || (near(values[i], b.values[i]) && equal(b, i + 1));
+        }
+        static constexpr bool near(T a, T b) {
+            return (a < b ? b - a : a - b) <= T(EPSILON);
+        }
+    };
+
+    /*
+    Returns the cross product of the vectors.
+    */
+    template <typename T>
+    constexpr Vec<3, T> cross(const Vec<3, T>& a, const Vec<3, T>& b) {
+        return Vec<3, T>(a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]);
+    }
+
+    template <std::size_t N, typename T>
+    constexpr Vec<N, T> operator*(T a, const Vec<N, T>& b) {
+        return b * a;
+    }
+
+    template <std::size_t N, typename T>
+    std::ostream& operator <<(std::ostream &outs, const Vec<N, T> &vec) {
+        for (std::size_t i = 0; i < N; ++i) {
+            outs << vec[i];
+            if (i < N - 1) {
+                outs << ", ";
+            }
+        }
+        return outs;
+    }
+
+    typedef Vec<2, float> Vec2f;
+    typedef Vec<3, float> Vec3f;
+    typedef Vec<4, float> Vec4f;
+    typedef Vec<2, int> Vec2i;
+    typedef Vec<3, int> Vec3i;
+
+    static_assert(sizeof(Vec2f) == 8, "Vec2f must be tightly packed");
+    static_assert(sizeof(Vec3f) == 12, "Vec3f must be tightly packed");
+}
+
+#endif
@@ -1,8 +1,12 @@
 #ifndef VECTOR4_HPP
 #define VECTOR4_HPP
 
+#include <cmath>
 #include <iostream>
-    
+
+#include "math/simd.hpp"
+#include "math/vec.hpp"
+
 namespace Math3D {
     class Vector4 {
      public:
@@ -14,6 +18,22 @@ namespace Math3D {
             Constructs a vector with the position x, y, z.
         */
         Vector4(float x, float y, float z);
+        /*
+            Constructs a vector with the position of the packed vector (w is set to 1).
+        */
+        explicit Vector4(const Vec3f& vec);
+        /*
+            Constructs a vector with the 4 components of the packed vector.
+        */
+        explicit Vector4(const Vec4f& vec);
+        /*
+            Returns the x, y, z components as a packed vector.
+        */
+        Vec3f toVec3() const;
+        /*
+            Returns the 4 components as a packed vector.
+        */
+        Vec4f toVec4() const;
         /*
             Returns the dot product of the vectors.
         */
@@ -69,10 +89,121 @@ namespace Math3D {
         const float* getValues() const;
 
      private:
-        float values[4];
+        alignas(16) float values[4];
     };
 
     std::ostream& operator <<(std::ostream &outs, const Vector4 &vec);
+
+    // The arithmetic below is defined inline so that callers in other translation units can inline it
+
+    inline Vector4::Vector4() {
+        values[0] = 0;
+        values[1] = 0;
+        values[2] = 0;
+        values[3] = 1;
+    }
+
+    inline Vector4::Vector4(float x, float y, float z) {
+        values[0] = x;
+        values[1] = y;
+        values[2] = z;
+        values[3] = 1;
+    }
+
+    inline Vector4::Vector4(const Vec3f& vec) {
+        values[0] = vec[0];
+        values[1] = vec[1];
+        values[2] = vec[2];
+        values[3] = 1;
+    }
+
+    inline Vector4::Vector4(const Vec4f& vec) {
+        values[0] = vec[0];
+        values[1] = vec[1];
+        values[2] = vec[2];
+        values[3] = vec[3];
+    }
+
+    inline Vec3f Vector4::toVec3() const {
+        return Vec3f(values[0], values[1], values[2]);
+    }
+
+    inline Vec4f Vector4::toVec4() const {
+        return Vec4f(values[0], values[1], values[2], values[3]);
+    }
+
+    inline float Vector4::dot(const Vector4& b) const {
+        return SIMD::dot3(SIMD::load(values), SIMD::load(b.values));
+    }
+
+    inline Vector4 Vector4::cross(const Vector4& b) const {
+        Vector4 out;
+
+        SIMD::store(out.values, SIMD::cross3(SIMD::load(values), SIMD::load(b.values)));
+        out.values[3] = 1;
+
+        return out;
+    }
+
+    inline float Vector4::magnitude() const {
+        return std::sqrt(dot(*this));
+    }
+
+    inline Vector4 Vector4::unit() const {
+        return operator/(magnitude());
+    }
+
+    inline Vector4 Vector4::operator*(float b) const {
+        Vector4 out;
+        SIMD::store(out.values, SIMD::mul(SIMD::load(values), SIMD::splat(b)));
+        return out;
+    }
+
+    inline Vector4 Vector4::operator*(const Vector4& b) const {
+        Vector4 out;
+        SIMD::store(out.values, SIMD::mul(SIMD::load(values), SIMD::load(b.values)));
+        return out;
+    }
+
+    inline Vector4 Vector4::operator/(float b) const {
+        Vector4 out;
+        SIMD::store(out.values, SIMD::div(SIMD::load(values), SIMD::splat(b)));
+        return out;
+    }
+
+    inline Vector4 Vector4::operator/(const Vector4& b) const {
+        Vector4 out;
+        SIMD::store(out.values, SIMD::div(SIMD::load(values), SIMD::load(b.values)));
+        return out;
+    }
+
+    inline Vector4 Vector4::operator+(const Vector4& b) const {
+        Vector4 out;
+        SIMD::store(out.values, SIMD::add(SIMD::load(values), SIMD::load(b.values)));
+        return out;
+    }
+
+    inline Vector4 Vector4::operator-(const Vector4& b) const {
+        Vector4 out;
+        SIMD::store(out.values, SIMD::sub(SIMD::load(values), SIMD::load(b.values)));
+        return out;
+    }
+
+    inline float& Vector4::operator[](int i) {
+        return values[i];
+    }
+
+    inline const float Vector4::operator[](int i) const {
+        return values[i];
+    }
+
+    inline float* Vector4::getValues() {
+        return values;
+    }
+
+    inline const float* Vector4::getValues() const {
+        return values;
+    }
 }
 
 #endif
\ No newline at end of file
@@ -7,21 +7,21 @@ using namespace Render3D;
 using namespace Math3D;
 
 Cuboid::Cuboid() : Primitive3D() {
-    vertices[0] = Vector4(-0.5, 0.5, 0.5);
-    vertices[1] = Vector4(-0.5, 0.5, -0.5);
-    vertices[2] = Vector4(0.5, 0.5, -0.5);
-    vertices[3] = Vector4(0.5, 0.5, 0.5);
-    vertices[4] = Vector4(-0.5, -0.5, 0.5);
-    vertices[5] = Vector4(-0.5, -0.5, -0.5);
-    vertices[6] = Vector4(0.5, -0.5, -0.5);
-    vertices[7] = Vector4(0.5, -0.5, 0.5);
-
-    normals[0] = Vector4(0, 1, 0); // Up
-    normals[1] = Vector4(0, -1, 0); // Down
-    normals[2] = Vector4(1, 0, 0); // Right
-    normals[3] = Vector4(-1, 0, 0); // Left
-    normals[4] = Vector4(0, 0, -1); // Forward
-    normals[5] = Vector4(0, 0, 1); // Backward
+    vertices[0] = Vec3f(-0.5f, 0.5f, 0.5f);
+    vertices[1] = Vec3f(-0.5f, 0.5f, -0.5f);
+    vertices[2] = Vec3f(0.5f, 0.5f, -0.5f);
+    vertices[3] = Vec3f(0.5f, 0.5f, 0.5f);
+    vertices[4] = Vec3f(-0.5f, -0.5f, 0.5f);
+    vertices[5] = Vec3f(-0.5f, -0.5f, -0.5f);
+    vertices[6] = Vec3f(0.5f, -0.5f, -0.5f);
+    vertices[7] = Vec3f(0.5f, -0.5f, 0.5f);
+
+    normals[0] = Vec3f(0, 1, 0); // Up
+    normals[1] = Vec3f(0, -1, 0); // Down
+    normals[2] = Vec3f(1, 0, 0); // Right
+    normals[3] = Vec3f(-1, 0, 0); // Left
+    normals[4] = Vec3f(0, 0, -1); // Forward
+    normals[5] = Vec3f(0, 0, 1); // Backward
 
     // Top Face
     vertexIndices[0] = 2;
@@ -96,6 +96,10 @@ Cuboid::Cuboid() : Primitive3D() {
     }
 }
 
+AABB Cuboid::getLocalBounds() const {
+    return AABB(Vector4(-0.5f, -0.5f, -0.5f), Vector4(0.5f, 0.5f, 0.5f));
+}
+
 BufferObject Cuboid::generateBuffers(GLuint clusterID) {
     for (unsigned int i = 0; i < bufferObjects.size(); ++i) {
         if (bufferObjects[i].first == clusterID) {
@@ -6,7 +6,8 @@
 
 #include "GL/glew.h"
 
-#include "math/vector4.hpp"
+#include "math/aabb.hpp"
+#include "math/vec.hpp"
 
 #include "objects/bufferobject.hpp"
 #include "objects/primitive3d.hpp"
@@ -16,6 +17,8 @@ namespace Render3D {
      public:
         Cuboid();
 
+        Math3D::AABB getLocalBounds() const;
+
         void render(Window& win, TextureManager& textureManager);
 
         void prepareContent(Window& win, TextureManager& textureManager);
@@ -25,8 +28,8 @@ namespace Render3D {
         std::vector<std::pair<GLuint, BufferObject> > bufferObjects;
         std::vector<std::pair<const Window*, GLuint> > VAOs;
 
-        Math3D::Vector4 vertices[8];
-        Math3D::Vector4 normals[6];
+        Math3D::Vec3f vertices[8];
+        Math3D::Vec3f normals[6];
         GLushort vertexIndices[36];
         GLushort normalIndices[36];
 
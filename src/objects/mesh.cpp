@@ -6,7 +6,7 @@
 using namespace Render3D;
 using namespace Math3D;
 
-Mesh::Mesh(const std::vector<Vector4>& verts, const std::vector<Vector4>& norms,
+Mesh::Mesh(const std::vector<Vec3f>& verts, const std::vector<Vec3f>& norms,
            const std::vector<TextureCoord>& texCs, const std::vector<TextureData>& texs,
            const std::vector<GLuint>& inds) {
     vertices = verts;
@@ -15,6 +15,9 @@ Mesh::Mesh(const std::vector<Vector4>& verts, const std::vector<Vector4>& norms,
     textures = texs;
     indices = inds;
     numVertices = indices.size();
+
+    boundingBox = AABB::fromPoints(vertices.data(), vertices.size());
+    boundingSphere = BoundingSphere::fromPoints(vertices.data(), vertices.size());
 }
 
 DoubleBufferObject Mesh::generateBuffers(GLuint clusterID) {
@@ -42,8 +45,8 @@ DoubleBufferObject Mesh::generateBuffers(GLuint clusterID) {
         data[i*8 + 4] = normals[i][1];
         data[i*8 + 5] = normals[i][2];
 
-        data[i*8 + 6] = texCoords[i].x;
-        data[i*8 + 7] = texCoords[i].y;
+        data[i*8 + 6] = texCoords[i][0];
+        data[i*8 + 7] = texCoords[i][1];
     }
 
     glBindBuffer(GL_ARRAY_BUFFER, buffers.firstID);
@@ -5,7 +5,9 @@
 #include <utility>
 #include <vector>
 
-#include "math/vector4.hpp"
+#include "math/aabb.hpp"
+#include "math/boundingsphere.hpp"
+#include "math/vec.hpp"
 
 #include "objects/bufferobject.hpp"
 #include "objects/primitive3d.hpp"
@@ -13,10 +15,7 @@
 #include "render_base/texture.hpp"
 
 namespace Render3D {
-    struct TextureCoord {
-        GLfloat x;
-        GLfloat y;
-    };
+    typedef Math3D::Vec<2, GLfloat> TextureCoord;
 
     struct TextureData {
         std::string type;
@@ -28,7 +27,7 @@ namespace Render3D {
 
     class Mesh {
      public:
-        Mesh(const std::vector<Math3D::Vector4>& verts, const std::vector<Math3D::Vector4>& norms,
+        Mesh(const std::vector<Math3D::Vec3f>& verts, const std::vector<Math3D::Vec3f>& norms,
              const std::vector<TextureCoord>& texCs, const std::vector<TextureData>& texs,
              const std::vector<GLuint>& inds);
 
@@ -38,19 +37,26 @@ namespace Render3D {
 
         int getVertexCount();
 
+        const Math3D::AABB& getBoundingBox() const { return boundingBox; }
+        const Math3D::BoundingSphere& getBoundingSphere() const { return boundingSphere; }
+
         void render(Shader& shader, Window& win, TextureManager& textureManager);
         void prepareContent(Window& win, TextureManager& textureManager);
         void destroyContent(Window& win, TextureManager& textureManager);
 
      private:
-        std::vector<Math3D::Vector4> vertices;
-        std::vector<Math3D::Vector4> normals;
+        std::vector<Math3D::Vec3f> vertices;
+        std::vector<Math3D::Vec3f> normals;
         std::vector<TextureCoord> texCoords;
         std::vector<TextureData> textures;
         std::vector<GLuint> indices;
 
         unsigned int numVertices;
 
+        // computed once from the vertices, which never change after construction
+        Math3D::AABB boundingBox;
+        Math3D::BoundingSphere boundingSphere;
+
         std::vector<std::pair<GLuint, DoubleBufferObject> > bufferObjects;
         std::vector<std::pair<const Window*, GLuint> > VAOs;
 
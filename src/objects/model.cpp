@@ -24,6 +24,10 @@ Model::Model(const char* filePath) : Primitive3D() {
 
     meshes.reserve(scene->mNumMeshes);
     processNode(scene->mRootNode, scene);
+
+    for (unsigned int i = 0; i < meshes.size(); ++i) {
+        localBounds = localBounds.merge(meshes[i].getBoundingBox());
+    }
 }
 
 Model::~Model() {
@@ -50,16 +54,16 @@ void Model::processNode(aiNode* node, const aiScene* scene) {
 Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
     //Process vertices, normals, and texture coordinates
 
-    std::vector<Vector4> vertices;
+    std::vector<Vec3f> vertices;
     vertices.reserve(mesh->mNumVertices);
-    std::vector<Vector4> normals;
+    std::vector<Vec3f> normals;
     normals.reserve(mesh->mNumVertices);
     std::vector<TextureCoord> textureCoords;
     std::vector<TextureData> textures;
     std::vector<GLuint> indices;
 
     for (GLuint i = 0; i < mesh->mNumVertices; ++i) {
-        Vector4 vert;
+        Vec3f vert;
         aiVector3t<float> aiVec;
         if (mesh->HasPositions()) {
             aiVec = mesh->mVertices[i];
@@ -71,7 +75,7 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
         }
         vertices.push_back(vert);
 
-        Vector4 norm;
+        Vec3f norm;
         if (mesh->HasNormals()) {
             aiVec = mesh->mNormals[i];
             norm[0] = aiVec.x;
@@ -84,8 +88,8 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
 
         TextureCoord tex;
         if (mesh->HasTextureCoords(0)) {
-            tex.x = mesh->mTextureCoords[0][i].x; 
-            tex.y = mesh->mTextureCoords[0][i].y;
+            tex[0] = mesh->mTextureCoords[0][i].x;
+            tex[1] = mesh->mTextureCoords[0][i].y;
         }
         textureCoords.push_back(tex);
     }
@@ -136,6 +140,10 @@ void Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::strin
     }
 }
 
+AABB Model::getLocalBounds() const {
+    return localBounds;
+}
+
 void Model::render(Window& win, TextureManager& textureManager) {
     applyVariables(win);
     
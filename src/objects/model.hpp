@@ -21,6 +21,8 @@ namespace Render3D {
 
         Model(const char *filePath);
 
+        Math3D::AABB getLocalBounds() const;
+
         void render(Window& win, TextureManager& textureManager);
 
         void prepareContent(Window& win, TextureManager& textureManager);
@@ -31,6 +33,7 @@ namespace Render3D {
         std::vector<std::pair<std::string, Texture*> > textureCache;
 
         std::vector<Mesh> meshes;
+        Math3D::AABB localBounds;
 
         void updateVertices();
 
@@ -16,13 +16,33 @@ Vector4 Primitive3D::getSize() const {
 }
 
 void Primitive3D::setCFrame(const Matrix4x4& value) {
-    cframe = value;
+    cframe = AffineTransform(value);
 }
 
 Matrix4x4 Primitive3D::getCFrame() const {
+    return cframe.toMatrix();
+}
+
+void Primitive3D::setTransform(const AffineTransform& value) {
+    cframe = value;
+}
+
+AffineTransform Primitive3D::getTransform() const {
     return cframe;
 }
 
+void Primitive3D::setRigidTransform(const RigidTransform& value) {
+    cframe = value.toTransform();
+}
+
+RigidTransform Primitive3D::getRigidTransform() const {
+    return RigidTransform(cframe);
+}
+
+AABB Primitive3D::getBounds() const {
+    return getLocalBounds().scale(size).transform(cframe);
+}
+
 void Primitive3D::setColor(const Color& value) {
     color = value;
 }
@@ -57,6 +77,13 @@ Instance* Primitive3D::newInstance(const Matrix4x4& cfr) {
     return newInstance;
 }
 
+Instance* Primitive3D::newInstance(const RigidTransform& cfr) {
+    Instance* newInstance = new Instance(cfr);
+    instances.push_back(newInstance);
+
+    return newInstance;
+}
+
 void Primitive3D::deleteInstance(Instance*& instance) {
     for (unsigned int i = 0; i < instances.size(); ++i) {
         if (instances[i] == instance) {
@@ -79,9 +106,9 @@ void Primitive3D::clearInstances() {
 }
 
 void Primitive3D::applyVariables(Window& win) {
-    Matrix4x4 rotation = cframe.rotation();
+    Matrix4x4 rotation = cframe.rotation().toMatrix();
 
-    modelCFrameVariable->setValue(win, cframe);
+    modelCFrameVariable->setValue(win, cframe.toMatrix());
     modelRotationVariable->setValue(win, rotation);
     modelSizeVariable->setValue(win, size);
     modelColorVariable->setValue(win, color);
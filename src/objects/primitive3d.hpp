@@ -4,7 +4,10 @@
 #include <string>
 #include <vector>
 
+#include "math/aabb.hpp"
+#include "math/affinetransform.hpp"
 #include "math/matrix4x4.hpp"
+#include "math/rigidtransform.hpp"
 #include "math/vector4.hpp"
 
 #include "render_base/color.hpp"
@@ -16,19 +19,29 @@ namespace Render3D {
     class TextureManager;
     class Window;
 
+    // Instance CFrames are rigid (rotation and position only) so they can be stored compactly,
+    // any scale in a CFrame given to an instance is dropped
     class Instance {
      public:
-        Instance() : cframe(Math3D::Matrix4x4()) {}
+        Instance() : cframe() {}
         Instance(const Math3D::Matrix4x4& cfr) : cframe(cfr) {}
+        Instance(const Math3D::AffineTransform& cfr) : cframe(cfr) {}
+        Instance(const Math3D::RigidTransform& cfr) : cframe(cfr) {}
         Instance(const Instance&) = delete;
         Instance(Instance&&) = delete;
         Instance& operator=(const Instance&) = delete;
         Instance& operator=(Instance&&) = delete;
 
-        void setCFrame(const Math3D::Matrix4x4& cfr) { cframe = cfr; }
-        Math3D::Matrix4x4 getCFrame() { return cframe; }
+        void setCFrame(const Math3D::Matrix4x4& cfr) { cframe = Math3D::RigidTransform(cfr); }
+        Math3D::Matrix4x4 getCFrame() { return cframe.toMatrix(); }
+
+        void setTransform(const Math3D::AffineTransform& cfr) { cframe = Math3D::RigidTransform(cfr); }
+        Math3D::AffineTransform getTransform() const { return cframe.toTransform(); }
+
+        void setRigidTransform(const Math3D::RigidTransform& cfr) { cframe = cfr; }
+        const Math3D::RigidTransform& getRigidTransform() const { return cframe; }
      private:
-        Math3D::Matrix4x4 cframe;
+        Math3D::RigidTransform cframe;
     };
 
     class Primitive3D { // Primitive3D is an abstract class
@@ -49,6 +62,17 @@ namespace Render3D {
         virtual void setCFrame(const Math3D::Matrix4x4& value);
         virtual Math3D::Matrix4x4 getCFrame() const;
 
+        virtual void setTransform(const Math3D::AffineTransform& value);
+        virtual Math3D::AffineTransform getTransform() const;
+
+        virtual void setRigidTransform(const Math3D::RigidTransform& value);
+        virtual Math3D::RigidTransform getRigidTransform() const;
+
+        // bounds of the geometry before size and CFrame are applied
+        virtual Math3D::AABB getLocalBounds() const = 0;
+        // world space bounds, instances are not included
+        virtual Math3D::AABB getBounds() const;
+
         virtual void setColor(const Color& value);
         virtual Color getColor() const;
 
@@ -56,6 +80,7 @@ namespace Render3D {
         virtual Shader* const getShader() const;
 
         virtual Instance* newInstance(const Math3D::Matrix4x4& cfr = Math3D::Matrix4x4());
+        virtual Instance* newInstance(const Math3D::RigidTransform& cfr);
         virtual void deleteInstance(Instance*& instance);
         virtual void clearInstances();
 
@@ -66,7 +91,7 @@ namespace Render3D {
      protected:
         Shader* shader;
         Math3D::Vector4 size;
-        Math3D::Matrix4x4 cframe;
+        Math3D::AffineTransform cframe;
         Color color;
         bool wireframeEnabled;
 
@@ -4,10 +4,18 @@ using namespace Render3D;
 using namespace Math3D;
 
 void Camera::setCFrame(const Matrix4x4& cfr) {
-    cframe = cfr;
+    cframe = AffineTransform(cfr);
 }
 
 Matrix4x4 Camera::getCFrame() const {
+    return cframe.toMatrix();
+}
+
+void Camera::setTransform(const AffineTransform& cfr) {
+    cframe = cfr;
+}
+
+const AffineTransform& Camera::getTransform() const {
     return cframe;
 }
 
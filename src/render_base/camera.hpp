@@ -1,6 +1,7 @@
 #ifndef CAMERA_HPP
 #define CAMERA_HPP
 
+#include "math/affinetransform.hpp"
 #include "math/matrix4x4.hpp"
 
 namespace Render3D {
@@ -12,6 +13,10 @@ namespace Render3D {
 
         Math3D::Matrix4x4 getCFrame() const;
 
+        void setTransform(const Math3D::AffineTransform& cframe);
+
+        const Math3D::AffineTransform& getTransform() const;
+
         void setFieldOfView(float fov);
 
         float getFieldOfView() const;
@@ -27,7 +32,7 @@ namespace Render3D {
         Math3D::Matrix4x4 getPerspective(float aspectRatio) const;
 
      private:
-        Math3D::Matrix4x4 cframe;
+        Math3D::AffineTransform cframe;
         float fieldOfView;
         float near;
         float far;
@@ -4,6 +4,8 @@
 #include <iostream>
 #include <utility>
 
+#include "math/frustum.hpp"
+
 #include "objects/primitive3d.hpp"
 
 #include "render_base/exception.hpp"
@@ -144,10 +146,11 @@ TextureManager* const Context3D::getTextureManager() {
 void Context3D::render() {
     window->makeCurrent();
 
-    Matrix4x4 cameraCFrame = camera.getCFrame();
+    const AffineTransform& cameraCFrame = camera.getTransform();
     Vector4 cameraPosition = cameraCFrame.position();
-    Matrix4x4 cameraInverse = cameraCFrame.inverse();
+    Matrix4x4 cameraInverse = cameraCFrame.inverse().toMatrix();
     Matrix4x4 projection = camera.getPerspective(window->getAspectRatio());
+    Frustum frustum(projection * cameraInverse);
 
     Vector4 lightPosition = Vector4(40, 300, 150);
     Color lightColor = Color(1, 1, 1);
@@ -170,6 +173,10 @@ void Context3D::render() {
             throw Exception("Tried to render object with no shader set");
         }
 
+        if (frustum.classify(object->getBounds()) == CONTAINMENT::OUTSIDE) {
+            continue;
+        }
+
         if (object->getShader() != currentShader) {
             currentShader = object->getShader();
             currentShader->use(*window);
@@ -0,0 +1,349 @@
+/*
+Checks the grid searches against astar(), built as the simpleEngine_test_astar target.
+
+The searches are run on random grids with walls and scattered blocked cells, with and without a cost
+layer. Every search that promises the shortest path must find a path exactly when astar() does, of the
+same cost, and the path must be a walk through walkable neighboring cells from start to end that really
+costs what it says. That includes jps(), which only jumps on the grids without costs. Any-angle paths must
+never cost more than the path of astar(). D* Lite is checked against a fresh astar() while the grid changes
+between its searches and its start moves along the path, and a PathFinder with a cache against astar() after
+a cell on cached paths is blocked. Landmark tables that don't fit the grid must not load. Prints each failure
+and exits with 1 if there were any.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "astar/anyangle.hpp"
+#include "astar/astar.hpp"
+#include "astar/bidirectional.hpp"
+#include "astar/dstarlite.hpp"
+#include "astar/grid.hpp"
+#include "astar/hdastar.hpp"
+#include "astar/jps.hpp"
+#include "astar/landmarks.hpp"
+#include "astar/pathcache.hpp"
+#include "astar/pathfinder.hpp"
+
+using namespace Math3D;
+
+namespace {
+    const int MAP_COUNT = 16;
+    const int QUERY_COUNT = 40;
+    const int THREADS = 4;
+    const int ROUND_COUNT = 30;
+    const int EDIT_COUNT = 6;
+
+    int failures = 0;
+
+    std::ostream& operator<<(std::ostream& outs, const Vec3i cell) {
+        return outs << "(" << cell[0] << ", " << cell[1] << ", " << cell[2] << ")";
+    }
+
+    void fail(const char* test, int map, const Vec3i start, const Vec3i end, const char* what) {
+        if (failures < 20) {
+            std::cout << "FAIL " << test << " on map " << map << " from " << start << " to " << end << ": " << what
+                      << std::endl;
+        }
+        failures++;
+    }
+
+    bool sameCost(double a, double b) {
+        return std::fabs(a - b) <= 1e-9 * (1.0 + std::fabs(b));
+    }
+
+    /*
+    Returns what the path really costs as a walk through neighboring cells, or -1 if it isn't one.
+    */
+    double walkCost(const Grid& grid, const Path& path, const Vec3i start, const Vec3i end) {
+        if (path.waypoints.empty() || !(path.waypoints.front() == start) || !(path.waypoints.back() == end)) {
+            return -1.0;
+        }
+        double cost = 0.0;
+        for (unsigned int i = 0; i < path.waypoints.size(); ++i) {
+            Vec3i cell = path.waypoints[i];
+            int index = grid.getIndex(cell[0], cell[1], cell[2]);
+            if (index < 0 || !grid.isWalkable(index)) {
+                return -1.0;
+            }
+            if (i > 0) {
+                Vec3i step = cell - path.waypoints[i - 1];
+                if (std::abs(step[0]) > 1 || std::abs(step[1]) > 1 || std::abs(step[2]) > 1 || step == Vec3i()) {
+                    return -1.0;
+                }
+                cost += distance(cell, path.waypoints[i - 1]) * grid.getCost(index);
+            }
+        }
+        return cost;
+    }
+
+    /*
+    Checks a path that should be the shortest one, as found by astar().
+    */
+    void checkShortest(const char* test, int map, const Grid& grid, const Path& path, const Path& shortest,
+                       const Vec3i start, const Vec3i end) {
+        if (path.found != shortest.found) {
+            fail(test, map, start, end, path.found ? "found a path astar() didn't" : "found no path");
+        } else if (path.found && !sameCost(path.cost, shortest.cost)) {
+            fail(test, map, start, end, "costs more than the path of astar()");
+        } else if (path.found && !sameCost(walkCost(grid, path, start, end), path.cost)) {
+            fail(test, map, start, end, "is not a walk of the cost it gives");
+        }
+    }
+
+    /*
+    Checks an any-angle path, which must be found exactly when astar() finds one, never cost more, and be
+    made of clear lines that add up to its cost.
+    */
+    void checkAnyAngle(const char* test, int map, const Grid& grid, const Path& path, const Path& shortest,
+                       const Vec3i start, const Vec3i end) {
+        if (path.found != shortest.found) {
+            fail(test, map, start, end, path.found ? "found a path astar() didn't" : "found no path");
+            return;
+        }
+        if (!path.found) {
+            return;
+        }
+        if (path.cost > shortest.cost && !sameCost(path.cost, shortest.cost)) {
+            fail(test, map, start, end, "costs more than the path of astar()");
+        }
+        double cost = 0.0;
+        for (unsigned int i = 1; i < path.waypoints.size(); ++i) {
+            cost += getLineCost(grid, path.waypoints[i - 1], path.waypoints[i]);
+        }
+        if (!(path.waypoints.front() == start) || !(path.waypoints.back() == end) || !sameCost(cost, path.cost)) {
+            fail(test, map, start, end, "is not made of clear lines of the cost it gives");
+        }
+    }
+
+    /*
+    A grid of random blocked cells and walls with a few gaps, with random costs in about a third of the cells
+    when costs is set.
+    */
+    void fillGrid(Grid& grid, std::mt19937& rng, int density, bool costs) {
+        Vec3i extents = grid.getExtents();
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::uniform_int_distribution<int> cost(1, 6);
+        for (int x = -extents[0]; x <= extents[0]; x++) {
+            for (int y = -extents[1]; y <= extents[1]; y++) {
+                for (int z = -extents[2]; z <= extents[2]; z++) {
+                    bool wall = x % 5 == 0 && percent(rng) >= 10;
+                    grid.setWalkable(x, y, z, !wall && percent(rng) >= density);
+                    if (costs && percent(rng) < 33) {
+                        grid.setCost(x, y, z, cost(rng));
+                    }
+                }
+            }
+        }
+    }
+
+    Vec3i randomCell(const Grid& grid, std::mt19937& rng) {
+        Vec3i extents = grid.getExtents();
+        Vec3i cell;
+        for (int axis = 0; axis < 3; ++axis) {
+            cell[axis] = std::uniform_int_distribution<int>(-extents[axis], extents[axis])(rng);
+        }
+        return cell;
+    }
+
+    /*
+    Blocks or opens a cell, or on grids with costs gives it a new cost.
+    */
+    void editCell(Grid& grid, std::mt19937& rng, const Vec3i cell, bool costs) {
+        if (costs && rng() % 2 == 0) {
+            grid.setCost(cell[0], cell[1], cell[2], std::uniform_int_distribution<int>(1, 6)(rng));
+        } else {
+            grid.setWalkable(cell[0], cell[1], cell[2], !grid.isWalkable(grid.getIndex(cell[0], cell[1], cell[2])));
+        }
+    }
+
+    bool samePath(const Path& a, const Path& b) {
+        return a.found == b.found && a.cost == b.cost && a.waypoints == b.waypoints;
+    }
+
+    /*
+    Runs a PathFinder with a cache over the same queries, checking the hit and miss counts, and that blocking
+    a cell on a cached path drops exactly the paths crossing it. Blocking can only make paths longer, so the
+    paths that are kept are still the shortest ones.
+    */
+    void checkCache(std::mt19937& rng) {
+        const char* test = "PathFinder with a cache";
+        Grid grid(10, 3, 10);
+        fillGrid(grid, rng, 8, false);
+        PathCache cache(grid);
+        PathFinder finder(grid, THREADS);
+        finder.setCache(&cache);
+
+        // each query starts from a different cell, so none of them can hit the path of another
+        std::vector<PathQuery> queries;
+        for (int index = 0; index < grid.getCellCount() && (int) queries.size() < 4 * QUERY_COUNT; index += 7) {
+            if (grid.isWalkable(index)) {
+                PathQuery query = {grid.getCell(index), randomCell(grid, rng)};
+                queries.push_back(query);
+            }
+        }
+        std::vector<Path> first = finder.findPaths(queries);
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            found += first[i].found;
+        }
+        if (cache.getHits() != 0 || cache.getMisses() != queries.size() || cache.getSize() != found) {
+            fail(test, -1, Vec3i(), Vec3i(), "counted the first batch wrong");
+        }
+
+        // only found paths are cached, the others miss again
+        std::vector<Path> second = finder.findPaths(queries);
+        if (cache.getHits() != found || cache.getMisses() != 2 * queries.size() - found) {
+            fail(test, -1, Vec3i(), Vec3i(), "counted the second batch wrong");
+        }
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            if (!samePath(first[i], second[i])) {
+                fail(test, -1, queries[i].start, queries[i].end, "gave a different path from the cache");
+            }
+        }
+
+        std::size_t longest = 0;
+        for (std::size_t i = 1; i < queries.size(); ++i) {
+            if (first[i].waypoints.size() > first[longest].waypoints.size()) {
+                longest = i;
+            }
+        }
+        if (first[longest].waypoints.size() < 3) {
+            fail(test, -1, Vec3i(), Vec3i(), "found no path to block");
+            return;
+        }
+        Vec3i blocked = first[longest].waypoints[first[longest].waypoints.size() / 2];
+        std::size_t crossing = 0;
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            const std::vector<Vec3i>& waypoints = first[i].waypoints;
+            crossing += std::find(waypoints.begin(), waypoints.end(), blocked) != waypoints.end();
+        }
+        grid.setWalkable(blocked[0], blocked[1], blocked[2], false);
+        if (crossing == 0 || cache.getSize() != found - crossing) {
+            fail(test, -1, queries[longest].start, queries[longest].end, "kept the wrong paths after a block");
+        }
+
+        SearchArena arena;
+        std::vector<Path> third = finder.findPaths(queries);
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            const Vec3i start = queries[i].start;
+            const Vec3i end = queries[i].end;
+            checkShortest(test, -1, grid, third[i], astar(grid, start, end, arena), start, end);
+        }
+    }
+
+    /*
+    Returns text with its line-th line replaced.
+    */
+    std::string replaceLine(const std::string& text, int line, const std::string& replacement) {
+        std::size_t begin = 0;
+        for (int i = 0; i < line; ++i) {
+            begin = text.find('\n', begin) + 1;
+        }
+        return text.substr(0, begin) + replacement + text.substr(text.find('\n', begin));
+    }
+
+    /*
+    Saves landmark tables and loads them back, then loads copies with a count or a landmark that doesn't fit
+    the grid, which have to be refused and leave no tables in use.
+    */
+    void checkLandmarkLoad(std::mt19937& rng) {
+        const char* test = "Landmarks::load";
+        Grid grid(4, 2, 4);
+        fillGrid(grid, rng, 8, false);
+        Landmarks landmarks(grid);
+        landmarks.build(2, 1);
+        std::ostringstream saved;
+        landmarks.save(saved);
+        std::string text = saved.str();
+
+        std::string broken[] = {
+            replaceLine(text, 0, "-1 0"),
+            replaceLine(text, 0, std::to_string(grid.getCellCount() + 1) + " 0"),
+            replaceLine(text, 3, "5 0 0"), // the second landmark outside the grid
+        };
+        for (const std::string& bad : broken) {
+            std::istringstream good(text);
+            if (!landmarks.load(good) || !landmarks.isReady() || landmarks.getCount() != 2) {
+                fail(test, -1, Vec3i(), Vec3i(), "refused the tables it saved");
+            }
+            std::istringstream ins(bad);
+            if (landmarks.load(ins) || landmarks.isReady() || landmarks.getTables() != nullptr) {
+                fail(test, -1, Vec3i(), Vec3i(), "took tables that don't fit the grid");
+            }
+        }
+    }
+}
+
+int main() {
+    std::mt19937 rng(12345);
+    SearchArena arena, forward, backward;
+    HdaArena hdaArena; // shared by every map, so it is also reused across grid sizes
+
+    for (int map = 0; map < MAP_COUNT; ++map) {
+        Grid grid(10 + map % 3, 3 + map % 2, 10);
+        bool costs = map % 2 == 1;
+        fillGrid(grid, rng, map % 4 * 8, costs);
+        if (grid.hasCosts() != costs) {
+            fail("fillGrid", map, Vec3i(), Vec3i(), "has the wrong cost layer");
+        }
+
+        for (int query = 0; query < QUERY_COUNT; ++query) {
+            Vec3i start = randomCell(grid, rng);
+            Vec3i end = query % 10 == 0 ? start : randomCell(grid, rng);
+            Path shortest = astar(grid, start, end, arena);
+
+            checkShortest("bidirectionalAstar", map, grid, bidirectionalAstar(grid, start, end, forward, backward),
+                          shortest, start, end);
+            checkShortest("hdaStar (1 thread)", map, grid, hdaStar(grid, start, end, hdaArena, 1), shortest, start,
+                          end);
+            checkShortest("hdaStar", map, grid, hdaStar(grid, start, end, hdaArena, THREADS), shortest, start, end);
+            // jps() only jumps on grids without a cost layer, on the others it is astar() itself
+            checkShortest("jps", map, grid, jps(grid, start, end, arena), shortest, start, end);
+            checkAnyAngle("thetaStar", map, grid, thetaStar(grid, start, end, arena), shortest, start, end);
+        }
+
+        // an agent walking its D* Lite path while the grid changes, some of the changes on the path itself
+        DStarLite planner(grid, randomCell(grid, rng), randomCell(grid, rng));
+        for (int round = 0; round < ROUND_COUNT; ++round) {
+            Vec3i start = planner.getStart();
+            Vec3i goal = planner.getGoal();
+            Path path = planner.findPath();
+            checkShortest("DStarLite", map, grid, path, astar(grid, start, goal, arena), start, goal);
+
+            for (int edit = 0; edit < EDIT_COUNT; ++edit) {
+                bool onPath = edit == 0 && path.waypoints.size() > 2;
+                Vec3i cell = onPath ? path.waypoints[1 + rng() % (path.waypoints.size() - 2)] : randomCell(grid, rng);
+                editCell(grid, rng, cell, costs);
+            }
+            if (path.waypoints.size() > 1) {
+                planner.setStart(path.waypoints[std::min<std::size_t>(3, path.waypoints.size() - 1)]);
+            } else if (round % 10 == 9) {
+                planner.setGoal(randomCell(grid, rng));
+            }
+        }
+    }
+
+    checkCache(rng);
+    checkLandmarkLoad(rng);
+
+    Grid small(2, 2, 2);
+    Vec3i outside(3, 0, 0);
+    if (bidirectionalAstar(small, Vec3i(), outside).found || hdaStar(small, outside, Vec3i(), THREADS).found) {
+        fail("searches", -1, Vec3i(), outside, "found a path to a cell outside the grid");
+    }
+
+    if (failures > 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,447 @@
+/*
+Checks the ray/triangle and ray/box kernels, built as the simpleEngine_test_intersection target.
+
+Every test is run through each code path of the kernels: the single intersect functions and the
+scalar tail of a batch, a lane of a 4 wide batch and a lane of an 8 wide batch. The paths must
+agree exactly with each other and, away from edges where float rounding decides, with a double
+precision Moller-Trumbore or slab test. Rays through the edges and vertices of triangles and the
+corners of boxes check the watertight kernels never miss. Empty boxes must be missed by every path.
+Prints each failure and exits with 1 if there were any.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include "math/math.hpp"
+
+using std::size_t;
+using namespace Math3D;
+
+namespace {
+    const float INF = std::numeric_limits<float>::infinity();
+    const int RANDOM_COUNT = 20000;
+    // batch sizes that put the tested lane in the scalar tail, a 4 wide block and an 8 wide block
+    const size_t PATH_SIZES[] = {3, 4, 8};
+    const char* PATH_NAMES[] = {"scalar", "scalar batch", "4 wide", "8 wide"};
+    const int PATH_COUNT = 4;
+
+    int failures = 0;
+
+    void fail(const char* test, const char* path, const Ray& ray) {
+        if (failures < 20) {
+            std::cout << "FAIL " << test << " (" << path << "), ray " << ray << std::endl;
+        }
+        failures++;
+    }
+
+    struct Reference {
+        bool hit;
+        bool clear; // far enough from the edges and ends that float rounding can't change the answer
+        double t, u, v;
+    };
+
+    /*
+    Moller-Trumbore in double precision on the float inputs.
+    */
+    Reference referenceTriangle(const Ray& ray, const Vector4& a, const Vector4& b, const Vector4& c, float tMax) {
+        double o[3], d[3], e1[3], e2[3], s[3];
+        for (int k = 0; k < 3; ++k) {
+            o[k] = ray.getOrigin()[k];
+            d[k] = ray.getDirection()[k];
+            e1[k] = (double) b[k] - a[k];
+            e2[k] = (double) c[k] - a[k];
+            s[k] = o[k] - a[k];
+        }
+        double p[3] = {d[1]*e2[2] - d[2]*e2[1], d[2]*e2[0] - d[0]*e2[2], d[0]*e2[1] - d[1]*e2[0]};
+        double q[3] = {s[1]*e1[2] - s[2]*e1[1], s[2]*e1[0] - s[0]*e1[2], s[0]*e1[1] - s[1]*e1[0]};
+        double det = e1[0]*p[0] + e1[1]*p[1] + e1[2]*p[2];
+
+        Reference ref;
+        ref.hit = false;
+        ref.clear = false;
+        ref.t = ref.u = ref.v = 0.0;
+        double scale = std::sqrt(e1[0]*e1[0] + e1[1]*e1[1] + e1[2]*e1[2])
+                     * std::sqrt(e2[0]*e2[0] + e2[1]*e2[1] + e2[2]*e2[2])
+                     * std::sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+        if (std::fabs(det) < 1e-3 * scale) { // close to parallel, too ill conditioned to compare
+            return ref;
+        }
+        ref.u = (s[0]*p[0] + s[1]*p[1] + s[2]*p[2]) / det;
+        ref.v = (d[0]*q[0] + d[1]*q[1] + d[2]*q[2]) / det;
+        ref.t = (e2[0]*q[0] + e2[1]*q[1] + e2[2]*q[2]) / det;
+        ref.hit = ref.u >= 0.0 && ref.v >= 0.0 && ref.u + ref.v <= 1.0 && ref.t > 0.0 && ref.t <= tMax;
+
+        const double margin = 1e-3;
+        double edge = std::min(std::min(std::fabs(ref.u), std::fabs(ref.v)), std::fabs(1.0 - ref.u - ref.v));
+        ref.clear = edge > margin && std::fabs(ref.t) > margin && std::fabs(ref.t - tMax) > margin;
+        return ref;
+    }
+
+    /*
+    The slab test in double precision, with rays parallel to a slab hitting only when they start inside it.
+    */
+    Reference referenceBox(const Ray& ray, const AABB& box, float tMax) {
+        double enter = 0.0, exit = tMax;
+        bool inside = true;
+        double closest = INF; // distance of the origin to a parallel slab's faces
+        for (int k = 0; k < 3; ++k) {
+            double o = ray.getOrigin()[k], d = ray.getDirection()[k];
+            double lo = box.getMin()[k], hi = box.getMax()[k];
+            if (d == 0.0) {
+                inside = inside && o >= lo && o <= hi;
+                closest = std::min(closest, std::min(std::fabs(o - lo), std::fabs(o - hi)));
+                continue;
+            }
+            double t1 = (lo - o) / d, t2 = (hi - o) / d;
+            enter = std::max(enter, std::min(t1, t2));
+            exit = std::min(exit, std::max(t1, t2));
+        }
+        Reference ref;
+        ref.hit = inside && enter <= exit;
+        ref.clear = closest > 1e-3 && std::fabs(exit - enter) > 1e-3 * std::max(1.0, std::fabs(exit));
+        ref.t = enter;
+        ref.u = ref.v = 0.0;
+        return ref;
+    }
+
+    struct Result {
+        bool hit;
+        RayHit rayHit;
+    };
+
+    bool same(const Result& a, const Result& b) {
+        if (a.hit != b.hit) {
+            return false;
+        }
+        return !a.hit || (a.rayHit.t == b.rayHit.t && a.rayHit.u == b.rayHit.u && a.rayHit.v == b.rayHit.v);
+    }
+
+    /*
+    Tests the triangle through every path, in the batches it is put at lane among triangles that can't be hit.
+    */
+    void triangleThroughPaths(const Ray& ray, const Vector4& a, const Vector4& b, const Vector4& c, float tMax,
+                              bool watertight, size_t lane, Result* results) {
+        results[0].hit = watertight ? intersectWatertight(ray, a, b, c, tMax, results[0].rayHit)
+                                    : intersect(ray, a, b, c, tMax, results[0].rayHit);
+        Vector4 far(1000.0f, 1000.0f, 1000.0f); // a degenerate triangle is never hit
+        for (int p = 0; p < PATH_COUNT - 1; ++p) {
+            TriangleBatch batch;
+            size_t at = lane % PATH_SIZES[p];
+            for (size_t i = 0; i < PATH_SIZES[p]; ++i) {
+                if (i == at) {
+                    batch.add(a, b, c);
+                } else {
+                    batch.add(far, far, far);
+                }
+            }
+            Result& result = results[p + 1];
+            result.hit = watertight ? batch.intersectWatertight(ray, tMax, result.rayHit)
+                                    : batch.intersect(ray, tMax, result.rayHit);
+            if (result.hit && result.rayHit.index != (int) at) {
+                fail("triangle batch index", PATH_NAMES[p + 1], ray);
+            }
+        }
+    }
+
+    void checkTriangle(const char* test, const Ray& ray, const Vector4& a, const Vector4& b, const Vector4& c,
+                       float tMax, bool watertight, size_t lane, bool expectHit) {
+        Result results[PATH_COUNT];
+        triangleThroughPaths(ray, a, b, c, tMax, watertight, lane, results);
+        for (int p = 1; p < PATH_COUNT; ++p) {
+            if (!same(results[0], results[p])) {
+                fail(test, PATH_NAMES[p], ray);
+            }
+        }
+        if (results[0].hit != expectHit) {
+            fail(test, PATH_NAMES[0], ray);
+        }
+    }
+
+    void randomTriangles(std::mt19937& rng, bool watertight) {
+        const char* test = watertight ? "random triangle, watertight" : "random triangle";
+        std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (int n = 0; n < RANDOM_COUNT; ++n) {
+            Vector4 a(dist(rng), dist(rng), dist(rng));
+            Vector4 b(dist(rng), dist(rng), dist(rng));
+            Vector4 c(dist(rng), dist(rng), dist(rng));
+            // aim near the triangle so about half the rays hit
+            float u = unit(rng) * 1.4f - 0.2f, v = unit(rng) * 1.4f - 0.2f;
+            Vector4 target = a + (b - a) * u + (c - a) * v;
+            Vector4 origin(dist(rng), dist(rng), dist(rng));
+            Ray ray(origin, target - origin);
+            float tMax = unit(rng) * 2.0f;
+
+            Result results[PATH_COUNT];
+            triangleThroughPaths(ray, a, b, c, tMax, watertight, n, results);
+            for (int p = 1; p < PATH_COUNT; ++p) {
+                if (!same(results[0], results[p])) {
+                    fail(test, PATH_NAMES[p], ray);
+                }
+            }
+
+            Reference ref = referenceTriangle(ray, a, b, c, tMax);
+            if (!ref.clear) {
+                continue;
+            }
+            const RayHit& hit = results[0].rayHit;
+            if (results[0].hit != ref.hit) {
+                fail(test, "reference", ray);
+            } else if (ref.hit && (std::fabs(hit.t - ref.t) > 1e-4 * std::max(1.0, ref.t)
+                                   || std::fabs(hit.u - ref.u) > 1e-4 || std::fabs(hit.v - ref.v) > 1e-4)) {
+                fail(test, "reference t, u, v", ray);
+            }
+        }
+    }
+
+    void triangleEdgesAndVertices() {
+        Vector4 a(0.0f, 0.0f, 0.0f), b(1.0f, 0.0f, 0.0f), c(0.0f, 1.0f, 0.0f);
+        Vector4 down(0.0f, 0.0f, -1.0f);
+        for (int w = 0; w < 2; ++w) {
+            bool watertight = w == 1;
+            for (size_t lane = 0; lane < 8; ++lane) {
+                // every one of these lands exactly on the boundary in float, so both kernels count it as a hit
+                checkTriangle("vertex hit", Ray(Vector4(0.0f, 0.0f, 1.0f), down), a, b, c, 2.0f, watertight, lane,
+                              true);
+                checkTriangle("vertex hit", Ray(Vector4(1.0f, 0.0f, 1.0f), down), a, b, c, 2.0f, watertight, lane,
+                              true);
+                checkTriangle("edge hit", Ray(Vector4(0.5f, 0.0f, 1.0f), down), a, b, c, 2.0f, watertight, lane,
+                              true);
+                checkTriangle("edge hit", Ray(Vector4(0.0f, 0.25f, 1.0f), down), a, b, c, 2.0f, watertight, lane,
+                              true);
+                checkTriangle("hypotenuse hit", Ray(Vector4(0.5f, 0.5f, 1.0f), down), a, b, c, 2.0f, watertight,
+                              lane, true);
+                checkTriangle("just outside edge", Ray(Vector4(0.5f, -1e-6f, 1.0f), down), a, b, c, 2.0f,
+                              watertight, lane, false);
+                checkTriangle("parallel to triangle", Ray(Vector4(0.2f, 0.2f, 0.0f), Vector4(1.0f, 0.0f, 0.0f)),
+                              a, b, c, 2.0f, watertight, lane, false);
+                checkTriangle("tMax short of triangle", Ray(Vector4(0.2f, 0.2f, 1.0f), down), a, b, c, 0.5f,
+                              watertight, lane, false);
+            }
+        }
+    }
+
+    /*
+    Rays through a point on the edge shared by two triangles, or the vertex shared by a fan of them, must hit
+    at least one with the watertight kernel whatever the rounding.
+    */
+    void watertightSharedEdges(std::mt19937& rng) {
+        std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (int n = 0; n < RANDOM_COUNT; ++n) {
+            Vector4 a(dist(rng), dist(rng), dist(rng)), b(dist(rng), dist(rng), dist(rng));
+            Vector4 c(dist(rng), dist(rng), dist(rng));
+            Vector4 d = a + b - c; // on the other side of edge ab, so abc and abd share only that edge
+            Vector4 target = a + (b - a) * unit(rng);
+            Vector4 origin = target + ((c - a).cross(b - a)) * (unit(rng) + 0.1f);
+            origin[3] = 1.0f;
+            Ray ray(origin, target - origin);
+
+            Result first[PATH_COUNT], second[PATH_COUNT];
+            triangleThroughPaths(ray, a, b, c, 2.0f, true, n, first);
+            triangleThroughPaths(ray, a, b, d, 2.0f, true, n, second);
+            for (int p = 0; p < PATH_COUNT; ++p) {
+                if (!first[p].hit && !second[p].hit) {
+                    fail("shared edge, watertight", PATH_NAMES[p], ray);
+                }
+            }
+
+            // a fan of four triangles around a
+            Vector4 e1 = b - a, e2 = (c - a).cross(b - a).cross(b - a);
+            Vector4 fan[4] = {a + e1, a + e2, a - e1, a - e2};
+            origin = a + e1.cross(e2) * (unit(rng) + 0.1f) + e1 * (unit(rng) * 0.1f);
+            origin[3] = 1.0f;
+            ray = Ray(origin, a - origin);
+            for (int p = 0; p < PATH_COUNT; ++p) {
+                bool any = false;
+                for (int k = 0; k < 4; ++k) {
+                    Result results[PATH_COUNT];
+                    triangleThroughPaths(ray, a, fan[k], fan[(k + 1) % 4], 2.0f, true, n, results);
+                    any = any || results[p].hit;
+                }
+                if (!any) {
+                    fail("shared vertex, watertight", PATH_NAMES[p], ray);
+                }
+            }
+        }
+    }
+
+    const size_t BOX_COUNT = 24; // a multiple of every path size
+
+    /*
+    Tests the boxes through every path, writing each path's entry distances (INF for a miss) to tNear[path].
+    */
+    void boxesThroughPaths(const Ray& ray, const AABB* boxes, float tMax, bool watertight,
+                           float (*tNear)[BOX_COUNT]) {
+        for (size_t i = 0; i < BOX_COUNT; ++i) {
+            float t;
+            bool hit = watertight ? intersectWatertight(ray, boxes[i], tMax, t) : intersect(ray, boxes[i], tMax, t);
+            tNear[0][i] = hit ? t : INF;
+        }
+        for (int p = 0; p < PATH_COUNT - 1; ++p) {
+            // batches of exactly the path's size, so every box goes through that path
+            for (size_t start = 0; start < BOX_COUNT; start += PATH_SIZES[p]) {
+                BoxBatch batch;
+                for (size_t i = 0; i < PATH_SIZES[p]; ++i) {
+                    batch.add(boxes[start + i]);
+                }
+                if (watertight) {
+                    batch.intersectWatertight(ray, tMax, tNear[p + 1] + start);
+                } else {
+                    batch.intersect(ray, tMax, tNear[p + 1] + start);
+                }
+            }
+        }
+    }
+
+    /*
+    Checks the paths agree exactly and match the reference where it is clear. When mustHit is set, every
+    box the reference hits at all must be hit.
+    */
+    void checkBoxes(const char* test, const Ray& ray, const AABB* boxes, float tMax, bool watertight, bool mustHit) {
+        float tNear[PATH_COUNT][BOX_COUNT];
+        boxesThroughPaths(ray, boxes, tMax, watertight, tNear);
+        for (size_t i = 0; i < BOX_COUNT; ++i) {
+            for (int p = 1; p < PATH_COUNT; ++p) {
+                if (tNear[p][i] != tNear[0][i]) {
+                    fail(test, PATH_NAMES[p], ray);
+                }
+            }
+            Reference ref = referenceBox(ray, boxes[i], tMax);
+            bool hit = tNear[0][i] != INF;
+            if (mustHit && ref.hit && !hit) {
+                fail(test, "reference, watertight miss", ray);
+            } else if (ref.clear && hit != ref.hit) {
+                fail(test, "reference", ray);
+            } else if (ref.clear && hit && std::fabs(tNear[0][i] - ref.t) > 1e-4 * std::max(1.0, ref.t)) {
+                fail(test, "reference tNear", ray);
+            }
+        }
+    }
+
+    AABB randomBox(std::mt19937& rng) {
+        std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> size(0.1f, 5.0f);
+        Vector4 min(dist(rng), dist(rng), dist(rng));
+        return AABB(min, min + Vector4(size(rng), size(rng), size(rng)));
+    }
+
+    void randomBoxes(std::mt19937& rng) {
+        std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        AABB boxes[BOX_COUNT];
+        for (int n = 0; n < RANDOM_COUNT / 10; ++n) {
+            for (size_t i = 0; i < BOX_COUNT; ++i) {
+                boxes[i] = randomBox(rng);
+            }
+            Vector4 origin(dist(rng), dist(rng), dist(rng));
+            Vector4 direction(dist(rng), dist(rng), dist(rng));
+            // every few rays are parallel to one or two of the slabs
+            if (n % 3 == 1) {
+                direction[n % 2] = 0.0f;
+            } else if (n % 3 == 2) {
+                direction[0] = 0.0f;
+                direction[2] = 0.0f;
+            }
+            Ray ray(origin, direction);
+            float tMax = unit(rng) * 4.0f;
+            checkBoxes("random box", ray, boxes, tMax, false, false);
+            checkBoxes("random box, watertight", ray, boxes, tMax, true, false);
+        }
+    }
+
+    /*
+    Rays aimed exactly at a corner or along the face of a box graze it, the watertight test must still hit.
+    */
+    void boxCornersAndFaces(std::mt19937& rng) {
+        std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        AABB boxes[BOX_COUNT];
+        for (int n = 0; n < RANDOM_COUNT / 10; ++n) {
+            for (size_t i = 0; i < BOX_COUNT; ++i) {
+                boxes[i] = randomBox(rng);
+            }
+            const AABB& box = boxes[n % BOX_COUNT];
+            Vector4 corner((n & 1) ? box.getMax()[0] : box.getMin()[0], (n & 2) ? box.getMax()[1] : box.getMin()[1],
+                           (n & 4) ? box.getMax()[2] : box.getMin()[2]);
+            Vector4 origin(dist(rng), dist(rng), dist(rng));
+            checkBoxes("ray at corner, watertight", Ray(origin, corner - origin), boxes, 2.0f, true, true);
+            checkBoxes("ray at corner", Ray(origin, corner - origin), boxes, 2.0f, false, false);
+
+            // starting inside the x and y slabs and travelling parallel to them
+            Vector4 inside = box.getMin() + (box.getMax() - box.getMin()) * 0.5f;
+            origin = Vector4(inside[0], inside[1], box.getMin()[2] - 1.0f - unit(rng));
+            checkBoxes("parallel ray inside slabs", Ray(origin, Vector4(0.0f, 0.0f, 1.0f)), boxes, 100.0f, false,
+                       true);
+            checkBoxes("parallel ray inside slabs, watertight", Ray(origin, Vector4(0.0f, 0.0f, 1.0f)), boxes, 100.0f,
+                       true, true);
+            // and just outside the x slab
+            origin[0] = box.getMax()[0] + 0.01f;
+            Ray outside(origin, Vector4(0.0f, 0.0f, 1.0f));
+            float tNear[PATH_COUNT][BOX_COUNT];
+            boxesThroughPaths(outside, boxes, 100.0f, true, tNear);
+            for (int p = 0; p < PATH_COUNT; ++p) {
+                if (tNear[p][n % BOX_COUNT] != INF) {
+                    fail("parallel ray outside slab", PATH_NAMES[p], outside);
+                }
+            }
+        }
+    }
+
+    /*
+    Empty boxes, the default AABB() and boxes with their corners swapped along an axis, are never hit by the
+    single test and must be missed by the batches too, in every lane and with an unbounded tMax.
+    */
+    void emptyBoxes(std::mt19937& rng) {
+        std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+        AABB boxes[BOX_COUNT];
+        for (int n = 0; n < RANDOM_COUNT / 10; ++n) {
+            for (size_t i = 0; i < BOX_COUNT; ++i) {
+                boxes[i] = randomBox(rng);
+                if ((i + n) % 3 == 0) {
+                    boxes[i] = AABB();
+                } else if ((i + n) % 3 == 1) {
+                    Vector4 min = boxes[i].getMin(), max = boxes[i].getMax();
+                    std::swap(min[i % 3], max[i % 3]);
+                    boxes[i] = AABB(min, max);
+                }
+            }
+            Ray ray(Vector4(dist(rng), dist(rng), dist(rng)), Vector4(dist(rng), dist(rng), dist(rng)));
+            float tMax = n % 2 == 0 ? INF : 100.0f;
+            for (int watertight = 0; watertight < 2; ++watertight) {
+                float tNear[PATH_COUNT][BOX_COUNT];
+                boxesThroughPaths(ray, boxes, tMax, watertight == 1, tNear);
+                for (size_t i = 0; i < BOX_COUNT; ++i) {
+                    for (int p = 0; p < PATH_COUNT; ++p) {
+                        if (boxes[i].isEmpty() ? tNear[p][i] != INF : tNear[p][i] != tNear[0][i]) {
+                            fail(watertight == 1 ? "empty box, watertight" : "empty box", PATH_NAMES[p], ray);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    std::mt19937 rng(12345);
+
+    randomTriangles(rng, false);
+    randomTriangles(rng, true);
+    triangleEdgesAndVertices();
+    watertightSharedEdges(rng);
+    randomBoxes(rng);
+    boxCornersAndFaces(rng);
+    emptyBoxes(rng);
+
+    if (failures > 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
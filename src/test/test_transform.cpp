@@ -0,0 +1,105 @@
+/*
+Checks that Quaternion and RigidTransform keep the rotation of the matrices and affine transforms they are
+made from, built as the simpleEngine_test_transform target. The matrices are random rotations, some scaled
+along their axes, which a RigidTransform has to drop without changing the rotation. Prints each failure
+and exits with 1 if there were any.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "math/math.hpp"
+
+using namespace Math3D;
+
+namespace {
+    const int RANDOM_COUNT = 10000;
+    const float TOLERANCE = 1e-4f;
+
+    int failures = 0;
+
+    void fail(const char* test, const Matrix4x4& mat, const char* what) {
+        if (failures < 20) {
+            std::cout << "FAIL " << test << ": " << what << " for" << std::endl << mat << std::endl;
+        }
+        failures++;
+    }
+
+    /*
+    Checks the rigid transform has a unit quaternion, the given rotation and the position of mat.
+    */
+    void checkRigid(const char* test, const RigidTransform& rigid, const Matrix4x4& rotation,
+                    const Matrix4x4& mat) {
+        if (std::fabs(rigid.getRotation().magnitude() - 1.0f) > TOLERANCE) {
+            fail(test, mat, "quaternion is not unit length");
+            return;
+        }
+        Matrix4x4 out = rigid.toMatrix();
+        for (int row = 0; row < 3; row++) {
+            for (int column = 0; column < 3; column++) {
+                if (std::fabs(out[row][column] - rotation[row][column]) > TOLERANCE) {
+                    fail(test, mat, "rotation changed");
+                    return;
+                }
+            }
+            if (out[row][3] != mat[row][3]) {
+                fail(test, mat, "position changed");
+                return;
+            }
+        }
+    }
+
+    /*
+    Returns mat with each of its axes (the columns of the rotation part) scaled.
+    */
+    Matrix4x4 scaleAxes(const Matrix4x4& mat, float x, float y, float z) {
+        Matrix4x4 out = mat;
+        float scale[3] = {x, y, z};
+        for (int row = 0; row < 3; row++) {
+            for (int column = 0; column < 3; column++) {
+                out[row][column] *= scale[column];
+            }
+        }
+        return out;
+    }
+
+    void checkRotation(const Matrix4x4& rotation, float x, float y, float z) {
+        Matrix4x4 scaled = scaleAxes(rotation, x, y, z);
+        checkRigid("RigidTransform(Matrix4x4)", RigidTransform(scaled), rotation, scaled);
+        checkRigid("RigidTransform(AffineTransform)", RigidTransform(AffineTransform(scaled)), rotation, scaled);
+        checkRigid("Quaternion::fromMatrix", RigidTransform(Quaternion::fromMatrix(scaled), scaled.position()),
+                   rotation, scaled);
+    }
+}
+
+int main() {
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> angle(-3.2f, 3.2f);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> scale(0.01f, 100.0f);
+
+    for (int n = 0; n < RANDOM_COUNT; ++n) {
+        Matrix4x4 rotation = Matrix4x4::fromEuler(angle(rng), angle(rng), angle(rng));
+        for (int row = 0; row < 3; row++) {
+            rotation[row][3] = dist(rng);
+        }
+        checkRotation(rotation, 1.0f, 1.0f, 1.0f);
+        float s = scale(rng);
+        checkRotation(rotation, s, s, s);
+        checkRotation(rotation, scale(rng), scale(rng), scale(rng));
+    }
+
+    // each branch of Shepperd's method, half turns about each axis have a trace of -1
+    checkRotation(Matrix4x4(), 2.0f, 3.0f, 4.0f);
+    checkRotation(Matrix4x4::fromEuler(3.14159265f, 0.0f, 0.0f), 0.5f, 2.0f, 5.0f);
+    checkRotation(Matrix4x4::fromEuler(0.0f, 3.14159265f, 0.0f), 0.5f, 2.0f, 5.0f);
+    checkRotation(Matrix4x4::fromEuler(0.0f, 0.0f, 3.14159265f), 0.5f, 2.0f, 5.0f);
+
+    if (failures > 0) {
+        std::cout << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}